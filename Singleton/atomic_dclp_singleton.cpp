@@ -0,0 +1,74 @@
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// Double-checked locking done right.
+// partially_threadSafe_singleton.cpp uses a plain Singleton* and is broken: another thread can
+// see instance != nullptr before the constructor's writes are visible. Making the pointer a
+// std::atomic and pairing a release store with acquire loads fixes exactly that.
+
+class Singleton {
+private:
+	static std::atomic<Singleton*> instance;
+	static std::mutex m;
+
+	Singleton() {
+		std::cout << "Constructor called by thread: "
+		          << std::this_thread::get_id() << "\n";
+	}
+
+public:
+	// Prevent copy and assignment
+	Singleton(const Singleton&) = delete;
+	Singleton& operator=(const Singleton&) = delete;
+
+	static Singleton* getInstance() {
+		// First check (not locked): one acquire load - a plain mov on x86
+		Singleton* p = instance.load(std::memory_order_acquire);
+		if (!p) {
+			std::lock_guard<std::mutex> lock_g(m);
+			// Second check (locked): relaxed is enough, the mutex already orders us
+			p = instance.load(std::memory_order_relaxed);
+			if (!p) {
+				p = new Singleton;
+				// release: the constructor's writes become visible before the pointer does
+				instance.store(p, std::memory_order_release);
+			}
+		}
+		return p;
+	}
+
+	void show() {
+		std::cout << "Instance address: " << this
+		          << " | Thread ID: " << std::this_thread::get_id() << "\n";
+	}
+};
+
+std::atomic<Singleton*> Singleton::instance{ nullptr };
+std::mutex Singleton::m;
+
+void accessSingleton() {
+	Singleton* s = Singleton::getInstance();
+	s->show();
+}
+
+int main() {
+	std::thread t1(accessSingleton);
+	std::thread t2(accessSingleton);
+	std::thread t3(accessSingleton);
+
+	t1.join();
+	t2.join();
+	t3.join();
+
+	return 0;
+}
+/*
+Why acquire/release fixes the reordering problem:
+1. The creating thread constructs the object, then does instance.store(p, release).
+   Release = none of the writes before it may be moved after it.
+2. A reader does instance.load(acquire). If it sees p, it is guaranteed to also see
+   everything written before the release store - i.e. a fully constructed Singleton.
+3. After the first call the fast path is a single load + compare, no lock at all.
+*/
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <memory>
+
+// Singleton with std::call_once: the library does the double-checked locking for us.
+// call_once runs the lambda exactly once even if many threads arrive together; the others
+// block until it has finished, and after that every call is just a check of the once_flag.
+
+class Singleton {
+private:
+	static std::once_flag initFlag;
+	static std::unique_ptr<Singleton> instance; // destroyed at program exit, no leak
+
+	Singleton() {
+		std::cout << "Constructor called by thread: "
+		          << std::this_thread::get_id() << "\n";
+	}
+
+public:
+	Singleton(const Singleton&) = delete;
+	Singleton& operator=(const Singleton&) = delete;
+
+	static Singleton& getInstance() {
+		std::call_once(initFlag, [] { instance.reset(new Singleton); });
+		return *instance;
+	}
+
+	void show() {
+		std::cout << "Instance address: " << this
+		          << " | Thread ID: " << std::this_thread::get_id() << "\n";
+	}
+};
+
+std::once_flag Singleton::initFlag;
+std::unique_ptr<Singleton> Singleton::instance;
+
+void accessSingleton() {
+	Singleton::getInstance().show();
+}
+
+int main() {
+	std::thread t1(accessSingleton);
+	std::thread t2(accessSingleton);
+	std::thread t3(accessSingleton);
+
+	t1.join();
+	t2.join();
+	t3.join();
+
+	return 0;
+}
+/*
+call_once vs. static local (guaranteed_threadSafe_singleton.cpp):
+- Both are thread-safe by the standard and cost about one load + branch after initialization.
+- call_once is useful when the object can't be a function-local static, e.g. it must be created
+  from a member function, with runtime arguments, or lives in a unique_ptr you may reset in tests.
+- If the lambda throws, the flag stays unset and the next caller tries again.
+*/
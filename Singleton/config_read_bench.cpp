@@ -0,0 +1,96 @@
+// Benchmark: a Singleton-held config read millions of times per second, written rarely (0.01%).
+// usage: config_read_bench [milliseconds per run=300] [max threads=64]
+//
+// Same Singleton shape as guaranteed_threadSafe_singleton.cpp, but 'data' is a small config
+// struct guarded four different ways:
+//   std::mutex         : readers serialize
+//   std::shared_mutex  : readers share, but all bump one reader counter (one hot cache line)
+//   PerCoreRWLock      : one reader counter per slot/cache line
+//   SeqLock            : readers only read; retry if a write happened meanwhile
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <vector>
+#include <cstdio>
+#include "../sync_primitives/seqlock.h"
+#include "../sync_primitives/per_core_rw_lock.h"
+#include "../common/bench_util.h"
+
+struct Config {
+	int data = 10;
+	int version = 0;
+	int timeoutMs = 250;
+	int retries = 3;
+	double ratio = 0.5;
+};
+
+class Singleton {
+private:
+	Singleton() = default;
+public:
+	static Singleton& getInstance() {
+		static Singleton instance;
+		return instance;
+	}
+	Singleton(const Singleton&) = delete;
+	Singleton& operator=(const Singleton&) = delete;
+
+	std::mutex mtx;
+	std::shared_mutex smtx;
+	PerCoreRWLock rw;
+	Config cfg; // guarded by whichever lock the run uses
+	SeqLock<Config> seq;
+};
+
+constexpr long long WriteEvery = 10000; // 0.01% of operations are writes
+
+template <typename Read, typename Write>
+double run(size_t threads, int ms, Read read, Write write) {
+	std::atomic<bool> stop{ false };
+	std::vector<long long> reads(threads, 0);
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			long long n = 0, sum = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				if (++n % WriteEvery == 0) write();
+				else sum += read();
+			}
+			bench::doNotOptimize(sum);
+			reads[t] = n - n / WriteEvery;
+		});
+	}
+	bench::Stopwatch sw;
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+	stop = true;
+	for (auto& w : workers) w.join();
+	long long total = 0;
+	for (long long r : reads) total += r;
+	return total / sw.seconds();
+}
+
+int main(int argc, char** argv) {
+	int ms = static_cast<int>(bench::argOr(argc, argv, 1, 300));
+	size_t maxThreads = static_cast<size_t>(bench::argOr(argc, argv, 2, 64));
+	Singleton& s = Singleton::getInstance();
+
+	printf("%7s %14s %14s %14s %14s   (M reads/s)\n", "threads", "mutex", "shared_mutex", "PerCoreRW", "SeqLock");
+	for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+		double a = run(threads, ms,
+			[&] { std::lock_guard<std::mutex> l(s.mtx); return s.cfg.data + s.cfg.version; },
+			[&] { std::lock_guard<std::mutex> l(s.mtx); s.cfg.version++; });
+		double b = run(threads, ms,
+			[&] { std::shared_lock<std::shared_mutex> l(s.smtx); return s.cfg.data + s.cfg.version; },
+			[&] { std::unique_lock<std::shared_mutex> l(s.smtx); s.cfg.version++; });
+		double c = run(threads, ms,
+			[&] { std::shared_lock<PerCoreRWLock> l(s.rw); return s.cfg.data + s.cfg.version; },
+			[&] { std::unique_lock<PerCoreRWLock> l(s.rw); s.cfg.version++; });
+		double d = run(threads, ms,
+			[&] { Config c = s.seq.load(); return c.data + c.version; },
+			[&] { s.seq.update([](Config& c) { c.version++; }); });
+		printf("%7zu %14.1f %14.1f %14.1f %14.1f\n", threads, a / 1e6, b / 1e6, c / 1e6, d / 1e6);
+	}
+	return 0;
+}
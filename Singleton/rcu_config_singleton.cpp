@@ -0,0 +1,82 @@
+#include <iostream>
+#include <thread>
+#include <string>
+#include <vector>
+#include <atomic>
+#include "../sync_primitives/snapshot.h"
+using namespace std::literals;
+
+// Config that can be reloaded while the program runs (not trivially copyable: has a string and a vector).
+struct Config {
+	int data = 10;
+	int version = 1;
+	std::string endpoint = "primary.local";
+	std::vector<int> limits = { 100, 200, 300 };
+};
+
+// Same Meyers singleton as guaranteed_threadSafe_singleton.cpp, but 'data' now lives in a Snapshot:
+// readers take a cheap read guard, a reload publishes a whole new Config.
+class Singleton {
+private:
+	Singleton() {
+		std::cout << "Cons.. called\n";
+	}
+public:
+	Snapshot<Config> config;
+
+	static Singleton& getInstance() {
+		static Singleton instance;
+		return instance;
+	}
+
+	Singleton(const Singleton&) = delete;
+	Singleton& operator=(const Singleton&) = delete;
+
+	void show() {
+		auto cfg = config.read(); // cfg stays valid until the end of this scope, even across a reload
+		std::cout << "v" << cfg->version << " data=" << cfg->data << " endpoint=" << cfg->endpoint << "\n";
+	}
+
+	void reload(int newData, const std::string& endpoint) {
+		config.update([&](Config& c) {
+			c.data = newData;
+			c.endpoint = endpoint;
+			c.version++;
+		});
+	}
+};
+
+int main() {
+	std::atomic<bool> stop{ false };
+
+	// readers never block, not even while reload() runs
+	std::thread reader([&] {
+		long long reads = 0, sum = 0;
+		while (!stop) {
+			auto cfg = Singleton::getInstance().config.read();
+			sum += cfg->data + cfg->limits[0];
+			reads++;
+		}
+		std::cout << "reader did " << reads << " reads (checksum " << sum << ")\n";
+	});
+
+	Singleton::getInstance().show();
+	for (int i = 1; i <= 3; i++) {
+		std::this_thread::sleep_for(50ms);
+		Singleton::getInstance().reload(10 + i, i % 2 ? "backup.local" : "primary.local");
+		Singleton::getInstance().show();
+	}
+	stop = true;
+	reader.join();
+
+	return 0;
+}
+
+/*
+How the old Config gets freed:
+1. reload() copies the current Config, edits the copy and swaps the pointer.
+2. The old pointer is "retired" with the current epoch.
+3. Each reader writes "I'm reading since epoch E" into its own slot on entry and clears it on exit.
+4. Once no reader is still inside a read section that began at or before the retire epoch,
+   nobody can hold the old pointer -> it is deleted (the grace period is over).
+*/
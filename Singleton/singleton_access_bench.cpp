@@ -0,0 +1,201 @@
+// Benchmark: what does getInstance() cost?
+// usage: singleton_access_bench [calls per thread=20000000] [max threads=64]
+//
+// Variants (each Tag gives a fresh, never-initialized singleton so first access can be measured repeatedly):
+//   Meyers          : function-local static (guaranteed_threadSafe_singleton.cpp) - static guard check
+//   atomic DCLP     : std::atomic pointer, acquire load + mutex on the slow path (atomic_dclp_singleton.cpp)
+//   call_once       : std::call_once + pointer (call_once_singleton.cpp)
+//   mutex always    : lock_guard on every call - what DCLP is trying to avoid
+//   TLS cached      : thread_local pointer filled from Meyers once per thread
+//   plain DCLP      : partially_threadSafe_singleton.cpp, plain pointer (steady state only: racy on first access)
+//
+// First access: T threads released at the same moment all call getInstance() while the constructor
+// runs for ~50us; reported is the time until the last thread has the instance.
+// Steady state: ns per call once the instance exists, with a compiler barrier so it is re-checked every call.
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <cstdio>
+#include "../common/bench_util.h"
+
+constexpr long long CtorNanos = 50000;
+
+template <int Tag>
+struct Payload {
+	int data = 10;
+	Payload() {
+		long long until = bench::nowNanos() + CtorNanos; // expensive constructor
+		while (bench::nowNanos() < until) {}
+	}
+};
+
+template <int Tag>
+struct Meyers {
+	static Payload<Tag>& getInstance() {
+		static Payload<Tag> instance;
+		return instance;
+	}
+};
+
+template <int Tag>
+struct AtomicDclp {
+	static inline std::atomic<Payload<Tag>*> instance{ nullptr };
+	static inline std::mutex m;
+	static Payload<Tag>& getInstance() {
+		Payload<Tag>* p = instance.load(std::memory_order_acquire);
+		if (!p) {
+			std::lock_guard<std::mutex> lock(m);
+			p = instance.load(std::memory_order_relaxed);
+			if (!p) {
+				p = new Payload<Tag>;
+				instance.store(p, std::memory_order_release);
+			}
+		}
+		return *p;
+	}
+};
+
+template <int Tag>
+struct CallOnce {
+	static inline std::once_flag flag;
+	static inline Payload<Tag>* instance = nullptr;
+	static Payload<Tag>& getInstance() {
+		std::call_once(flag, [] { instance = new Payload<Tag>; });
+		return *instance;
+	}
+};
+
+template <int Tag>
+struct MutexAlways {
+	static inline std::mutex m;
+	static inline Payload<Tag>* instance = nullptr;
+	static Payload<Tag>& getInstance() {
+		std::lock_guard<std::mutex> lock(m);
+		if (!instance) instance = new Payload<Tag>;
+		return *instance;
+	}
+};
+
+template <int Tag>
+struct TlsCached {
+	static Payload<Tag>& slowPath() {
+		static Payload<Tag> instance; // Meyers singleton, separate from Meyers<Tag>'s
+		return instance;
+	}
+	static Payload<Tag>& getInstance() {
+		thread_local Payload<Tag>* cached = nullptr;
+		if (!cached) cached = &slowPath();
+		return *cached;
+	}
+};
+
+template <int Tag>
+struct PlainDclp {
+	static inline Payload<Tag>* instance = nullptr;
+	static inline std::mutex m;
+	static Payload<Tag>& getInstance() {
+		if (!instance) {
+			std::lock_guard<std::mutex> lock(m);
+			if (!instance) instance = new Payload<Tag>;
+		}
+		return *instance;
+	}
+};
+
+// Time until the last of T simultaneously released threads has the instance (us).
+template <template <int> class S, int Tag>
+double firstAccess(size_t threads) {
+	std::atomic<bool> go{ false };
+	std::atomic<size_t> ready{ 0 };
+	std::vector<long long> doneAt(threads);
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			ready++;
+			while (!go.load(std::memory_order_acquire)) {}
+			bench::doNotOptimize(S<Tag>::getInstance().data);
+			doneAt[t] = bench::nowNanos();
+		});
+	}
+	while (ready.load() < threads) std::this_thread::yield();
+	long long start = bench::nowNanos();
+	go.store(true, std::memory_order_release);
+	for (auto& w : workers) w.join();
+	long long last = 0;
+	for (long long d : doneAt) last = std::max(last, d);
+	return (last - start) / 1e3;
+}
+
+// ns per getInstance() call on T threads once initialized.
+template <template <int> class S, int Tag>
+double steadyState(size_t threads, long long calls) {
+	bench::doNotOptimize(S<Tag>::getInstance().data); // initialize first
+	std::vector<double> nsPerCall(threads);
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			bench::Stopwatch sw;
+			int sum = 0;
+			for (long long i = 0; i < calls; i++) {
+				sum += S<Tag>::getInstance().data;
+				bench::clobberMemory(); // forget everything: re-check the singleton each call
+			}
+			bench::doNotOptimize(sum);
+			nsPerCall[t] = sw.nanos() / calls;
+		});
+	}
+	for (auto& w : workers) w.join();
+	double total = 0;
+	for (double v : nsPerCall) total += v;
+	return total / threads;
+}
+
+// One fresh Tag per thread count: 1, 2, 4, ... 64.
+template <template <int> class S, int... Idx>
+void firstAccessRow(const char* name, size_t maxThreads, std::integer_sequence<int, Idx...>) {
+	printf("%-14s", name);
+	auto cell = [&](size_t threads, auto measure) {
+		if (threads <= maxThreads) printf(" %9.1f", measure(threads));
+	};
+	(cell(static_cast<size_t>(1) << Idx, [](size_t t) { return firstAccess<S, Idx>(t); }), ...);
+	printf("\n");
+}
+
+template <template <int> class S>
+void steadyRow(const char* name, size_t maxThreads, long long calls) {
+	printf("%-14s", name);
+	for (size_t t = 1; t <= maxThreads; t *= 2) printf(" %9.2f", steadyState<S, 100>(t, calls));
+	printf("\n");
+}
+
+int main(int argc, char** argv) {
+	long long calls = bench::argOr(argc, argv, 1, 20000000);
+	size_t maxThreads = static_cast<size_t>(bench::argOr(argc, argv, 2, 64));
+	using Tags = std::make_integer_sequence<int, 7>; // 2^0 .. 2^6 threads
+
+	auto header = [&](const char* title) {
+		printf("\n%s\n%-14s", title, "threads");
+		for (size_t t = 1; t <= maxThreads; t *= 2) printf(" %9zu", t);
+		printf("\n");
+	};
+
+	header("first access: us until every thread has the instance (ctor ~50us)");
+	firstAccessRow<Meyers>("Meyers", maxThreads, Tags{});
+	firstAccessRow<AtomicDclp>("atomic DCLP", maxThreads, Tags{});
+	firstAccessRow<CallOnce>("call_once", maxThreads, Tags{});
+	firstAccessRow<MutexAlways>("mutex always", maxThreads, Tags{});
+	firstAccessRow<TlsCached>("TLS cached", maxThreads, Tags{});
+
+	header("steady state: ns per getInstance()");
+	steadyRow<Meyers>("Meyers", maxThreads, calls);
+	steadyRow<AtomicDclp>("atomic DCLP", maxThreads, calls);
+	steadyRow<CallOnce>("call_once", maxThreads, calls);
+	steadyRow<MutexAlways>("mutex always", maxThreads, calls / 10);
+	steadyRow<TlsCached>("TLS cached", maxThreads, calls);
+	steadyRow<PlainDclp>("plain DCLP*", maxThreads, calls);
+	printf("* racy on first access (see partially_threadSafe_singleton.cpp); shown for cost only\n");
+	return 0;
+}
@@ -0,0 +1,126 @@
+// Benchmark + restart check for SnowflakeIDGenerator.
+// usage: snowflake_id_bench [milliseconds per run=500] [threads=4] [hwm file=snowflake.hwm]
+//
+// Runs without persistence and with leases of 10s / 1s / 100ms / 10ms, and reports IDs/s,
+// how many fsyncs happened, their average cost and how many IDs each fsync paid for.
+// Shorter leases = more fsyncs; the hot path only notices if it has to wait for one (lease waits).
+// Then checks that leases of a few ms never leave generateID() waiting forever, and that a restart
+// never reissues an ID.
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include "snowflake_id_generator.h"
+#include "../common/bench_util.h"
+
+void run(const char* name, SnowflakeIDGenerator::Options opt, size_t threads, int ms) {
+	SnowflakeIDGenerator gen(opt);
+	long long startupFsyncs = gen.stats().fsyncs.load();
+	long long startupNanos = gen.stats().fsyncNanos.load();
+	std::atomic<bool> stop{ false };
+	std::vector<long long> counts(threads, 0);
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			long long n = 0;
+			uint64_t prev = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				for (int i = 0; i < 64; i++) {
+					uint64_t id = gen.generateID();
+					if (id <= prev) std::printf("ordering violated!\n");
+					prev = id;
+				}
+				n += 64;
+			}
+			counts[t] = n;
+		});
+	}
+	bench::Stopwatch sw;
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+	stop = true;
+	for (auto& w : workers) w.join();
+	double secs = sw.seconds();
+
+	long long total = 0;
+	for (long long c : counts) total += c;
+	const auto& st = gen.stats();
+	long long fsyncs = st.fsyncs.load() - startupFsyncs;
+	long long fsyncNanos = st.fsyncNanos.load() - startupNanos;
+	printf("%-16s %8.2f M ids/s  fsyncs %5lld  avg fsync %8.1f us  ids/fsync %12.0f  lease waits %lld\n", name,
+		total / secs / 1e6, fsyncs, fsyncs ? fsyncNanos / 1e3 / fsyncs : 0.0,
+		fsyncs ? static_cast<double>(total) / fsyncs : 0.0, st.leaseWaits.load());
+}
+
+// One thread, leases of a few ms: the clock regularly passes a new lease while it is still being
+// written, and the waiting generateID() has to ask for another renewal instead of sleeping forever.
+bool shortLeaseCheck(const std::string& file, int ms) {
+	for (int64_t lease : { 2, 3, 5, 8 }) {
+		SnowflakeIDGenerator::Options opt;
+		opt.hwmFile = file;
+		opt.leaseMs = lease;
+		SnowflakeIDGenerator gen(opt);
+		std::atomic<bool> stop{ false }, done{ false };
+		long long n = 0;
+		std::thread worker([&] {
+			while (!stop.load(std::memory_order_relaxed)) {
+				gen.generateID();
+				n++;
+			}
+			done = true;
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+		stop = true;
+		// watchdog: a stuck generateID() never returns, so the thread cannot be joined
+		for (int i = 0; i < 200 && !done; i++) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		if (!done) {
+			printf("short lease check FAILED: generateID() hangs with lease %lld ms\n", static_cast<long long>(lease));
+			std::fflush(stdout);
+			std::_Exit(1);
+		}
+		worker.join();
+		printf("lease %lld ms: %lld ids, %lld lease waits\n", static_cast<long long>(lease), n, gen.stats().leaseWaits.load());
+	}
+	return true;
+}
+
+// Issue some IDs, "crash" (drop the generator), start again: the first new ID must be larger.
+bool restartCheck(const std::string& file) {
+	SnowflakeIDGenerator::Options opt;
+	opt.hwmFile = file;
+	opt.leaseMs = 60000; // next start jumps ahead by up to a minute - the price of never reissuing
+	uint64_t lastBefore = 0;
+	{
+		SnowflakeIDGenerator gen(opt);
+		for (int i = 0; i < 100000; i++) lastBefore = gen.generateID();
+	}
+	SnowflakeIDGenerator again(opt);
+	uint64_t firstAfter = again.generateID();
+	auto a = again.decode(lastBefore), b = again.decode(firstAfter);
+	printf("restart: last before %llu (ms %lld), first after %llu (ms %lld)\n",
+		static_cast<unsigned long long>(lastBefore), static_cast<long long>(a.ms),
+		static_cast<unsigned long long>(firstAfter), static_cast<long long>(b.ms));
+	return firstAfter > lastBefore;
+}
+
+int main(int argc, char** argv) {
+	int ms = static_cast<int>(bench::argOr(argc, argv, 1, 500));
+	size_t threads = static_cast<size_t>(bench::argOr(argc, argv, 2, 4));
+	std::string file = argc > 3 ? argv[3] : "snowflake.hwm";
+
+	SnowflakeIDGenerator::Options opt;
+	opt.node = 7;
+	run("no persistence", opt, threads, ms);
+	opt.hwmFile = file;
+	for (int64_t lease : { 10000, 1000, 100, 10 }) {
+		opt.leaseMs = lease;
+		std::string name = "lease " + std::to_string(lease) + " ms";
+		run(name.c_str(), opt, threads, ms);
+	}
+	if (shortLeaseCheck(file, ms)) printf("short lease check ok\n");
+	printf("%s\n", restartCheck(file) ? "restart check ok" : "restart check FAILED: ID reissued");
+	std::remove(file.c_str());
+	return 0;
+}
@@ -0,0 +1,269 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <exception>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+--------------------------------------------------------------------------------
+SnowflakeIDGenerator: 64-bit IDs that stay unique across restarts
+--------------------------------------------------------------------------------
+Layout (most significant bit first):
+    0 | 41 bits milliseconds since epochMs | 10 bits node | 12 bits sequence
+    -> sorted by time, ~69 years of range, 1024 nodes, 4096 IDs per ms per node.
+
+Hot path: one CAS on the last issued ID. The next ID is computed from the last one:
+    - clock moved forward       -> (now, seq 0)
+    - same ms                   -> (same ms, seq + 1)
+    - sequence used up (4096)   -> borrow the next ms: (ms + 1, seq 0)
+    - clock went BACKWARDS      -> ignore the clock and keep counting from the last ID
+  so IDs are strictly increasing even if NTP steps the clock back.
+
+Crash safety (optional, hwmFile set):
+    The file holds a high-water mark: a timestamp no issued ID has reached yet.
+    On start we continue from max(now, file value), so IDs from before a crash are never
+    reissued, even if the clock is now behind. The mark is leased in ranges (leaseMs ahead)
+    and renewed by a background thread (write temp file, fsync, rename) when half the
+    lease is used. The hot path only waits if it overtakes an unfinished renewal.
+    A lease only counts once it is on disk: if a renewal fails, the old lease stays and
+    a generateID() that is waiting for the new one gets the I/O error.
+--------------------------------------------------------------------------------
+*/
+class SnowflakeIDGenerator {
+public:
+	static constexpr int NodeBits = 10;
+	static constexpr int SeqBits = 12;
+	static constexpr uint64_t MaxNode = (1u << NodeBits) - 1;
+	static constexpr uint64_t MaxSeq = (1u << SeqBits) - 1;
+
+	struct Options {
+		uint16_t node = 0;
+		int64_t epochMs = 1704067200000; // 2024-01-01T00:00:00Z
+		std::string hwmFile;             // empty = no persistence
+		int64_t leaseMs = 10000;         // >= 2: a renewal must reach past the ms a waiting ID borrows
+	};
+
+	struct Parts {
+		int64_t ms;
+		uint32_t node;
+		uint32_t seq;
+	};
+
+	struct Stats {
+		std::atomic<long long> fsyncs{ 0 };
+		std::atomic<long long> fsyncNanos{ 0 };
+		std::atomic<long long> leaseWaits{ 0 };   // hot path had to wait for a renewal
+		std::atomic<long long> clockRegressions{ 0 };
+	};
+
+	explicit SnowflakeIDGenerator(const Options& opt) : opt_(opt) {
+		if (opt_.node > MaxNode) throw std::invalid_argument("node id does not fit in 10 bits");
+		if (opt_.leaseMs < 2) throw std::invalid_argument("leaseMs must be at least 2");
+		int64_t now = nowMs();
+		int64_t floor = 0;
+		if (!opt_.hwmFile.empty()) {
+			floor = readHighWaterMark();
+			int64_t lease = std::max(now, floor) + opt_.leaseMs;
+			writeHighWaterMark(lease); // synchronous once at startup
+			leasedUntil_.store(lease, std::memory_order_relaxed);
+		}
+		// pretend the last ID was the final one of ms (floor - 1): the next one lands at >= floor
+		last_.store(floor > 0 ? pack(floor - 1, MaxSeq) : 0, std::memory_order_relaxed);
+		if (!opt_.hwmFile.empty()) persister_ = std::thread(&SnowflakeIDGenerator::persistLoop, this);
+	}
+
+	~SnowflakeIDGenerator() {
+		if (persister_.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(mtx_);
+				stopping_ = true;
+			}
+			cv_.notify_all();
+			persister_.join();
+		}
+	}
+
+	SnowflakeIDGenerator(const SnowflakeIDGenerator&) = delete;
+	SnowflakeIDGenerator& operator=(const SnowflakeIDGenerator&) = delete;
+
+	uint64_t generateID() {
+		uint64_t old = last_.load(std::memory_order_relaxed);
+		while (true) {
+			int64_t now = nowMs();
+			Parts p = decode(old);
+			uint64_t next;
+			if (now > p.ms) next = pack(now, 0);
+			else if (p.seq < MaxSeq) next = old + 1; // same ms, next sequence number
+			else next = pack(p.ms + 1, 0);
+
+			int64_t ms = decode(next).ms;
+			if (ms >= leasedUntil_.load(std::memory_order_acquire)) {
+				waitForLease(ms);
+				old = last_.load(std::memory_order_relaxed);
+				continue;
+			}
+			if (last_.compare_exchange_weak(old, next, std::memory_order_relaxed)) {
+				if (now < p.ms) stats_.clockRegressions.fetch_add(1, std::memory_order_relaxed);
+				maybeRenew(ms);
+				return next;
+			}
+		}
+	}
+
+	Parts decode(uint64_t id) const {
+		return { static_cast<int64_t>(id >> (NodeBits + SeqBits)),
+			static_cast<uint32_t>((id >> SeqBits) & MaxNode), static_cast<uint32_t>(id & MaxSeq) };
+	}
+
+	// Wall-clock time an ID was created at (ms since the Unix epoch).
+	int64_t unixMillis(uint64_t id) const { return decode(id).ms + opt_.epochMs; }
+
+	const Stats& stats() const { return stats_; }
+
+private:
+	Options opt_;
+	alignas(64) std::atomic<uint64_t> last_{ 0 };
+	alignas(64) std::atomic<int64_t> leasedUntil_{ INT64_MAX };
+	std::atomic<bool> renewRequested_{ false };
+	Stats stats_;
+
+	std::mutex mtx_;
+	std::condition_variable cv_;      // persister waits for requests here
+	std::condition_variable leaseCv_; // hot path waits for a renewed lease here
+	bool stopping_ = false;
+	std::exception_ptr persistError_; // last failed renewal, guarded by mtx_
+	uint64_t persistFailures_ = 0;    // guarded by mtx_
+	std::thread persister_;
+
+	int64_t nowMs() const {
+		auto t = std::chrono::system_clock::now().time_since_epoch();
+		return std::chrono::duration_cast<std::chrono::milliseconds>(t).count() - opt_.epochMs;
+	}
+
+	uint64_t pack(int64_t ms, uint64_t seq) const {
+		return (static_cast<uint64_t>(ms) << (NodeBits + SeqBits)) | (static_cast<uint64_t>(opt_.node) << SeqBits) | seq;
+	}
+
+	// Ask for a renewal once half of the lease is used up. Two relaxed loads when nothing to do.
+	void maybeRenew(int64_t ms) {
+		if (opt_.hwmFile.empty()) return;
+		int64_t until = leasedUntil_.load(std::memory_order_relaxed);
+		if (ms < until - opt_.leaseMs / 2 || renewRequested_.load(std::memory_order_relaxed)) return;
+		if (!renewRequested_.exchange(true)) {
+			std::lock_guard<std::mutex> lock(mtx_);
+			cv_.notify_one();
+		}
+	}
+
+	void waitForLease(int64_t ms) {
+		stats_.leaseWaits.fetch_add(1, std::memory_order_relaxed);
+		std::unique_lock<std::mutex> lock(mtx_);
+		// only a renewal that fails after this request counts: every waiter gets a fresh attempt
+		uint64_t failures = persistFailures_;
+		while (leasedUntil_.load(std::memory_order_acquire) <= ms) {
+			if (stopping_) throw std::runtime_error("id generator is shutting down");
+			if (persistFailures_ != failures) std::rethrow_exception(persistError_);
+			// ask again on every wakeup: the clock may have passed the lease that was just written
+			renewRequested_.store(true);
+			cv_.notify_one();
+			leaseCv_.wait(lock);
+		}
+	}
+
+	void persistLoop() {
+		std::unique_lock<std::mutex> lock(mtx_);
+		while (true) {
+			cv_.wait(lock, [&] { return stopping_ || renewRequested_.load(); });
+			if (stopping_) return;
+			// extend from wherever the IDs are now, so a lease that ran ahead is covered too
+			int64_t issued = decode(last_.load(std::memory_order_relaxed)).ms;
+			int64_t next = std::max(nowMs(), issued) + opt_.leaseMs;
+			next = std::max(next, leasedUntil_.load(std::memory_order_relaxed)); // never shrink after a clock step back
+			lock.unlock();
+			std::exception_ptr error;
+			try {
+				writeHighWaterMark(next); // the only place that does I/O after startup
+			} catch (...) {
+				error = std::current_exception();
+			}
+			lock.lock();
+			if (error) {
+				// keep the old lease: IDs past it were never made durable
+				persistError_ = error;
+				persistFailures_++;
+			} else {
+				leasedUntil_.store(next, std::memory_order_release);
+			}
+			renewRequested_.store(false);
+			leaseCv_.notify_all();
+		}
+	}
+
+	// 0 if the file does not exist yet (first start). Any other failure throws: starting from the
+	// clock instead could reissue IDs after a clock step back.
+	int64_t readHighWaterMark() const {
+		FILE* f = std::fopen(opt_.hwmFile.c_str(), "r");
+		if (!f) {
+			if (errno == ENOENT) return 0;
+			throw std::runtime_error("cannot read " + opt_.hwmFile + ": " + std::strerror(errno));
+		}
+		long long v = 0;
+		bool parsed = std::fscanf(f, "%lld", &v) == 1 && v >= 0;
+		std::fclose(f);
+		if (!parsed) throw std::runtime_error("no high-water mark in " + opt_.hwmFile);
+		return v;
+	}
+
+	// Crash-safe replace: write a temp file, flush it to disk, then rename over the old one.
+	// Throws if any step fails; the temp file is removed. Up to the rename the old mark stays in
+	// place; if only the directory fsync fails, the new mark is already there but may not be durable.
+	void writeHighWaterMark(int64_t value) {
+		auto start = std::chrono::steady_clock::now();
+		std::string tmp = opt_.hwmFile + ".tmp";
+		auto fail = [&](const char* step) {
+			std::remove(tmp.c_str());
+			throw std::runtime_error(std::string("cannot persist ") + opt_.hwmFile + ": " + step + " failed");
+		};
+		FILE* f = std::fopen(tmp.c_str(), "w");
+		if (!f) throw std::runtime_error("cannot write " + tmp);
+		const char* error = nullptr;
+		if (std::fprintf(f, "%lld\n", static_cast<long long>(value)) <= 0 || std::fflush(f) != 0) error = "write";
+#ifdef _WIN32
+		else if (_commit(_fileno(f)) != 0) error = "flush to disk";
+		if (std::fclose(f) != 0 && !error) error = "close";
+		if (error) fail(error);
+		if (!MoveFileExA(tmp.c_str(), opt_.hwmFile.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) fail("rename");
+#else
+		else if (fsync(fileno(f)) != 0) error = "fsync";
+		if (std::fclose(f) != 0 && !error) error = "close";
+		if (error) fail(error);
+		if (std::rename(tmp.c_str(), opt_.hwmFile.c_str()) != 0) fail("rename");
+		// make the rename itself durable
+		std::string dir = opt_.hwmFile.find('/') == std::string::npos ? "." : opt_.hwmFile.substr(0, opt_.hwmFile.rfind('/') + 1);
+		int dfd = open(dir.c_str(), O_RDONLY);
+		if (dfd < 0) fail("opening the directory");
+		bool dirSynced = fsync(dfd) == 0;
+		close(dfd);
+		if (!dirSynced) fail("directory fsync");
+#endif
+		stats_.fsyncs.fetch_add(1, std::memory_order_relaxed);
+		stats_.fsyncNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+	}
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+/*
+--------------------------------------------------------------------------------
+UniqueIDGenerator with two modes
+--------------------------------------------------------------------------------
+Mode::Atomic (default, the original behaviour):
+    Every call does next_id_++ on one std::atomic. IDs are globally increasing,
+    but every thread hammers the same cache line, so it stops scaling with threads.
+
+Mode::Leased:
+    Each thread leases a block of IDs (initially 4096) from the global counter
+    with a single fetch_add and then hands them out from a thread_local range.
+    - Unique: two blocks never overlap, because each comes from one fetch_add.
+    - Monotonic only per thread: thread A may hand out 5000 after thread B handed out 9000.
+    - Block size adapts per thread: a thread that burns through its block quickly gets a
+      bigger one next time, a thread that needed a long time gets a smaller one.
+    - IDs left in a thread's block when the thread exits are never used (gaps, not duplicates).
+Switching mode at runtime is safe: leased blocks were already reserved in next_id_, and every
+switch drops what is left of each thread's block (mode generation), so a thread's IDs keep
+increasing across Leased -> Atomic -> Leased too.
+--------------------------------------------------------------------------------
+*/
+class UniqueIDGenerator {
+public:
+    enum class Mode { Atomic, Leased };
+
+    static constexpr long long InitialBlock = 4096;
+    static constexpr long long MinBlock = 64;
+    static constexpr long long MaxBlock = 1 << 20;
+
+private:
+    // Private constructor: Only getInstance() can call this.
+    UniqueIDGenerator() : next_id_(1), mode_(Mode::Atomic) { /* std::cout << "ID Gen created\n"; */ }
+
+    // Disallow copying/moving to ensure one instance.
+    UniqueIDGenerator(const UniqueIDGenerator&) = delete;
+    UniqueIDGenerator& operator=(const UniqueIDGenerator&) = delete;
+
+    alignas(64) std::atomic<long long> next_id_; // Thread-safe counter for IDs.
+    alignas(64) std::atomic<Mode> mode_;         // read on every call: keep it off next_id_'s line
+    std::atomic<unsigned> modeGen_{ 0 };         // bumped by every mode switch, invalidates leases
+
+    // Per-thread lease: [next, end) is still ours to hand out.
+    struct Lease {
+        long long next = 0;
+        long long end = 0;
+        long long block = InitialBlock;
+        unsigned gen = 0; // modeGen_ when the block was leased
+        std::chrono::steady_clock::time_point leasedAt{};
+    };
+
+    static Lease& lease() {
+        thread_local Lease l;
+        return l;
+    }
+
+    long long refill(Lease& l) {
+        auto now = std::chrono::steady_clock::now();
+        if (l.end != 0) {
+            // aim for roughly one global fetch_add per thread per millisecond
+            auto took = now - l.leasedAt;
+            if (took < std::chrono::microseconds(500)) l.block = std::min(l.block * 2, MaxBlock);
+            else if (took > std::chrono::milliseconds(50)) l.block = std::max(l.block / 2, MinBlock);
+        }
+        l.next = next_id_.fetch_add(l.block, std::memory_order_relaxed);
+        l.end = l.next + l.block;
+        l.leasedAt = now;
+        l.gen = modeGen_.load(std::memory_order_relaxed);
+        return l.next++;
+    }
+
+public:
+    // Public static method to get the single instance.
+    // C++11+ ensures thread-safe initialization of static local 'instance'.
+    static UniqueIDGenerator& getInstance() {
+        static UniqueIDGenerator instance; // Created once, on first call.
+        return instance;
+    }
+
+    void setMode(Mode m) {
+        if (mode() == m) return;
+        modeGen_.fetch_add(1, std::memory_order_relaxed);
+        mode_.store(m, std::memory_order_release); // whoever sees the new mode sees the new generation
+    }
+    Mode mode() const { return mode_.load(std::memory_order_acquire); }
+
+    // Generates and returns a new unique ID using the current mode.
+    long long generateID() {
+        return mode() == Mode::Leased ? generateLeasedID() : generateOrderedID();
+    }
+
+    // Globally increasing ID (original behaviour).
+    long long generateOrderedID() {
+        return next_id_++; // Atomically increments and returns old value.
+    }
+
+    // Unique, increasing per thread only; no shared write in the common case.
+    long long generateLeasedID() {
+        Lease& l = lease();
+        // a block from before a mode switch may be below IDs this thread issued in Atomic mode since
+        if (l.next < l.end && l.gen == modeGen_.load(std::memory_order_relaxed)) return l.next++;
+        return refill(l);
+    }
+
+    // Current block size of the calling thread (for diagnostics/benchmarks).
+    long long leaseBlockSize() const { return lease().block; }
+};
@@ -1,5 +1,8 @@
 #include <iostream>
 #include <atomic> // For thread-safe ID counter
+#include <thread>
+#include <vector>
+#include <string>
 
 /*
 --------------------------------------------------------------------------------
@@ -17,30 +20,8 @@ A Singleton `UniqueIDGenerator` acts as a single, central source.
 --------------------------------------------------------------------------------
 */
 
-class UniqueIDGenerator {
-private:
-    // Private constructor: Only getInstance() can call this.
-    UniqueIDGenerator() : next_id_(1) { /* std::cout << "ID Gen created\n"; */ }
-
-    // Disallow copying/moving to ensure one instance.
-    UniqueIDGenerator(const UniqueIDGenerator&) = delete;
-    UniqueIDGenerator& operator=(const UniqueIDGenerator&) = delete;
-
-    std::atomic<long long> next_id_; // Thread-safe counter for IDs.
-
-public:
-    // Public static method to get the single instance.
-    // C++11+ ensures thread-safe initialization of static local 'instance'.
-    static UniqueIDGenerator& getInstance() {
-        static UniqueIDGenerator instance; // Created once, on first call.
-        return instance;
-    }
-
-    // Generates and returns a new unique ID.
-    long long generateID() {
-        return next_id_++; // Atomically increments and returns old value.
-    }
-};
+// The class lives in unique_id_generator.h (it also has a block-leasing mode for many threads).
+#include "unique_id_generator.h"
 
 int main() {
     // Get the singleton instance
@@ -54,6 +35,18 @@ int main() {
     UniqueIDGenerator& another_ref_to_generator = UniqueIDGenerator::getInstance();
     std::cout << "ID 3 (via another_ref): " << another_ref_to_generator.generateID() << std::endl;
 
+    // Many threads: lease blocks of IDs instead of fighting over one counter.
+    // Still unique, but only increasing within each thread.
+    generator.setMode(UniqueIDGenerator::Mode::Leased);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 2; t++) {
+        workers.emplace_back([t] {
+            long long id = UniqueIDGenerator::getInstance().generateID();
+            std::cout << ("worker " + std::to_string(t) + " got ID " + std::to_string(id) + "\n");
+        });
+    }
+    for (auto& w : workers) w.join();
+
     return 0;
 }
 
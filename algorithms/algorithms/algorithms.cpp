@@ -21,13 +21,15 @@
 //}
 
 // sort array of std::pair 
+// note: a comparator must return false for equal elements (strict weak ordering), otherwise
+// std::sort may read past the end of the array - so equal seconds return false here.
+// for 100M+ elements see parallel_sort.h (psort::sort with psort::PairFirstAscSecondDesc).
 bool comp(std::pair<int,int>p1, std::pair<int, int>p2) {
 	if (p1.first < p2.first) {
 		return true;
 	}
 	if (p1.first == p2.first) {
-		if (p1.second < p2.second) return false;
-		else return true;
+		return p1.second > p2.second;
 	}
 	return false;
 }
@@ -69,6 +71,7 @@ int main() {
 
 
 	// finding max elem in any index range
+	// (for millions of queries on the same array see range_query.h: O(1) per query after a build)
 	int a[5] = { 33,6,71,8,44 };
 	int maxi = INT_MIN;
 	// let 
@@ -113,6 +116,7 @@ int main() {
 	std::cout << cnt << "\n";
 
 	// using other way - count()
+	// (on huge int arrays simd_scan.h has simd::count / find / min_element / accumulate with the same arguments)
 	// count(firstIterator, lastIterator, x)
 	std::cout << "count of 1: " << std::count(nums, nums + 8, 1) << "\n";
 
@@ -144,6 +148,7 @@ int main() {
 
 	// searching - binary search algo
 	// this algo only works on sorted arrays
+	// (millions of searches on one big sorted array: search_index.h re-lays it out cache-friendly)
 	// arr[] -> {1, 5, 7, 9, 10}
 	// x = 9
 	// return true if 9 exists otherwise false
@@ -220,6 +225,7 @@ int main() {
 	}*/
 
 	// we also have prev_permutation(iter1, iter2)
+	// (searching all n! orders of 12-14 items: permutations.h - Lehmer rank/unrank ranges on the thread pool, Heap's algorithm)
 
 
 	// COMPARATOR
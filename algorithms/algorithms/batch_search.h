@@ -0,0 +1,82 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include "search_index.h"
+
+/*
+Many lower_bound searches on one sorted array at once.
+ - One std::lower_bound is a chain of dependent cache misses: the CPU cannot load probe 2 before
+   probe 1 came back, so a search in a 1 GB array is ~25 misses back to back, mostly idle.
+ - lower_bound_interleaved : runs a group of searches in lockstep. A branchless lower_bound takes the
+   same number of steps for every query (it only depends on n), so step s of all G searches is done
+   together, and each one prefetches its next probe before moving to the next search.
+   Up to G misses are in flight instead of one.
+   (Coroutine interleaving gets the same effect with a suspend after each prefetch; for a search
+   where all queries take the same steps a plain loop over the group is simpler and cheaper.)
+ - lower_bound_sweep : queries that arrive sorted need no independent searches at all. Each search
+   starts at the previous answer and gallops forward (1, 2, 4, ... elements) before a binary search,
+   so a dense batch is a merge-like linear pass and a sparse one costs O(log gap) per query.
+ - lower_bound_many : a sorted batch that is dense enough (on average <= 256 keys between two
+   queries, so galloping stays inside a few cache lines) is swept; anything else is interleaved.
+out[i] = std::lower_bound(sorted.begin(), sorted.end(), queries[i]) - sorted.begin() in every case.
+*/
+namespace search {
+
+constexpr size_t InterleaveGroup = 16;
+
+template <typename T>
+void lower_bound_interleaved(std::span<const T> sorted, std::span<const T> queries, std::span<size_t> out) {
+	const T* data = sorted.data();
+	const size_t n = sorted.size();
+	if (n == 0) {
+		std::fill(out.begin(), out.begin() + queries.size(), size_t(0));
+		return;
+	}
+	for (size_t q0 = 0; q0 < queries.size(); q0 += InterleaveGroup) {
+		const size_t g = std::min(InterleaveGroup, queries.size() - q0);
+		const T* base[InterleaveGroup];
+		for (size_t j = 0; j < g; j++) base[j] = data;
+		size_t len = n;
+		while (len > 1) {
+			const size_t half = len / 2;
+			const size_t nextHalf = (len - half) / 2;
+			for (size_t j = 0; j < g; j++) {
+				base[j] = (base[j][half] < queries[q0 + j]) ? base[j] + half : base[j]; // cmov, no branch
+				detail::prefetch(base[j] + nextHalf);
+			}
+			len -= half;
+		}
+		for (size_t j = 0; j < g; j++) out[q0 + j] = static_cast<size_t>(base[j] - data) + (*base[j] < queries[q0 + j]);
+	}
+}
+
+// Requires queries in ascending order.
+template <typename T>
+void lower_bound_sweep(std::span<const T> sorted, std::span<const T> queries, std::span<size_t> out) {
+	const size_t n = sorted.size();
+	size_t pos = 0; // answer for the previous query; the next one is never before it
+	for (size_t q = 0; q < queries.size(); q++) {
+		const T& x = queries[q];
+		if (pos < n && sorted[pos] < x) {
+			// gallop: find a window (lo, hi] that holds the answer, then binary search inside it
+			size_t lo = pos, step = 1, hi = pos + 1;
+			while (hi < n && sorted[hi] < x) {
+				lo = hi;
+				step *= 2;
+				hi = std::min(n, lo + step);
+			}
+			pos = static_cast<size_t>(std::lower_bound(sorted.begin() + lo + 1, sorted.begin() + hi, x) - sorted.begin());
+		}
+		out[q] = pos;
+	}
+}
+
+template <typename T>
+void lower_bound_many(std::span<const T> sorted, std::span<const T> queries, std::span<size_t> out) {
+	const bool dense = queries.size() * 256 >= sorted.size();
+	if (dense && std::is_sorted(queries.begin(), queries.end())) lower_bound_sweep(sorted, queries, out);
+	else lower_bound_interleaved(sorted, queries, out);
+}
+
+} // namespace search
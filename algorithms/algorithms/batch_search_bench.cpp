@@ -0,0 +1,92 @@
+// Benchmark: queries/sec of batched lower_bound against one std::lower_bound per query.
+// usage: batch_search_bench [n=67108864 (256 MB of ints)] [queries=1048576]
+//
+// The same random queries are answered in batches of 1, 2, 4 ... 1024:
+//   std::lower_bound : one search after the other
+//   interleaved      : lower_bound_interleaved, groups of 16 searches in lockstep with prefetching
+//   sweep            : the batch is sorted first (time included), then lower_bound_sweep;
+//                      the indices are mapped back to query order
+//   presorted        : the queries arrive already sorted (e.g. from a sorted join), no sort cost;
+//                      lower_bound_many picks the sweep only when the batch is dense enough
+// Every answer is checked against std::lower_bound.
+#include <iostream>
+#include <vector>
+#include <random>
+#include <numeric>
+#include <cstdio>
+#include "batch_search.h"
+#include "../../common/bench_util.h"
+
+int main(int argc, char** argv) {
+	size_t n = static_cast<size_t>(bench::argOr(argc, argv, 1, 64 << 20));
+	size_t total = static_cast<size_t>(bench::argOr(argc, argv, 2, 1 << 20));
+	std::mt19937 rng(3);
+	std::vector<int> sorted(n);
+	for (auto& x : sorted) x = static_cast<int>(rng() >> 1);
+	std::sort(sorted.begin(), sorted.end());
+	std::vector<int> queries(total);
+	for (auto& x : queries) x = static_cast<int>(rng() >> 1);
+
+	std::vector<size_t> expect(total);
+	for (size_t q = 0; q < total; q++) {
+		expect[q] = static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), queries[q]) - sorted.begin());
+	}
+	std::span<const int> keys(sorted);
+
+	std::printf("n = %zu, %zu queries, rates in M queries/s\n", n, total);
+	std::printf("%6s %16s %12s %12s %16s\n", "batch", "std::lower", "interleaved", "sweep", "presorted auto");
+	for (size_t batch = 1; batch <= 1024; batch *= 2) {
+		size_t usable = total / batch * batch;
+		std::vector<size_t> out(usable);
+		bool ok = true;
+		auto check = [&] { ok = ok && std::equal(out.begin(), out.end(), expect.begin()); };
+
+		bench::Stopwatch sw;
+		for (size_t b = 0; b < usable; b += batch) {
+			for (size_t q = b; q < b + batch; q++) {
+				out[q] = static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), queries[q]) - sorted.begin());
+			}
+		}
+		double tStd = sw.seconds();
+		check();
+
+		sw.reset();
+		for (size_t b = 0; b < usable; b += batch) {
+			search::lower_bound_interleaved(keys, std::span<const int>(queries).subspan(b, batch),
+				std::span<size_t>(out).subspan(b, batch));
+		}
+		double tInter = sw.seconds();
+		check();
+
+		// sorted copy of each batch plus the permutation back to query order
+		std::vector<int> sortedQ(batch);
+		std::vector<uint32_t> perm(batch);
+		std::vector<size_t> tmp(batch);
+		sw.reset();
+		for (size_t b = 0; b < usable; b += batch) {
+			std::iota(perm.begin(), perm.end(), 0u);
+			std::sort(perm.begin(), perm.end(), [&](uint32_t l, uint32_t r) { return queries[b + l] < queries[b + r]; });
+			for (size_t j = 0; j < batch; j++) sortedQ[j] = queries[b + perm[j]];
+			search::lower_bound_sweep(keys, std::span<const int>(sortedQ), std::span<size_t>(tmp));
+			for (size_t j = 0; j < batch; j++) out[b + perm[j]] = tmp[j];
+		}
+		double tSweep = sw.seconds();
+		check();
+
+		// presorted input: sort every batch up front, outside the timer
+		std::vector<int> pre(queries.begin(), queries.begin() + usable);
+		for (size_t b = 0; b < usable; b += batch) std::sort(pre.begin() + b, pre.begin() + b + batch);
+		sw.reset();
+		for (size_t b = 0; b < usable; b += batch) {
+			search::lower_bound_many(keys, std::span<const int>(pre).subspan(b, batch), std::span<size_t>(out).subspan(b, batch));
+		}
+		double tPre = sw.seconds();
+		for (size_t q = 0; q < usable && ok; q++) {
+			ok = out[q] == static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), pre[q]) - sorted.begin());
+		}
+
+		std::printf("%6zu %16.2f %12.2f %12.2f %16.2f%s\n", batch, usable / tStd / 1e6, usable / tInter / 1e6,
+			usable / tSweep / 1e6, usable / tPre / 1e6, ok ? "" : "  MISMATCH");
+	}
+	return 0;
+}
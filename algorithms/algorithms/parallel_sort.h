@@ -0,0 +1,281 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <version>
+#include "../../common/thread_pool.h"
+
+// std::execution needs a parallel backend (MSVC has one built in, libstdc++ uses TBB: link with -ltbb).
+// Define PSORT_NO_STD_EXECUTION to build without it; StdParallel then falls back to SampleSort.
+#if defined(__cpp_lib_parallel_algorithm) && !defined(PSORT_NO_STD_EXECUTION)
+#include <execution>
+#define PSORT_HAS_STD_EXECUTION 1
+#else
+#define PSORT_HAS_STD_EXECUTION 0
+#endif
+
+/*
+Sort module for big vectors (100M+ ints or std::pair<int,int>):
+ - std::sort is one thread. Below ~64K elements it is still the fastest, so everything starts there.
+ - StdParallel : std::sort / std::stable_sort with std::execution::par_unseq (library backend).
+ - SampleSort  : pick splitters from a sample, scatter every element into its bucket, sort buckets
+                 in parallel on the ThreadPool. One pass over memory plus the bucket sorts.
+ - MergeSort   : sort equal chunks in parallel, then merge pairs of runs. Each merge is itself split
+                 into pieces with "co-rank" (binary search for where output index k comes from),
+                 so the last merge still uses every thread.
+ - Auto        : small input -> std::sort; already sorted -> nothing; strictly reversed -> std::reverse;
+                 otherwise the library parallel sort if there is one, else SampleSort.
+Both in-house sorts keep equal elements in order when asked to (stableSort): the scatter and
+std::merge never reorder equal keys, and chunks/buckets are sorted with std::stable_sort.
+
+Comparators must be a strict weak ordering: comp(a, a) must be false. The old comp() in
+algorithms.cpp returned true for equal pairs, which lets std::sort run past the end of the array;
+PairFirstAscSecondDesc below is the same order done right.
+*/
+namespace psort {
+
+enum class Strategy { Auto, Serial, StdParallel, SampleSort, MergeSort };
+
+inline const char* toString(Strategy s) {
+	switch (s) {
+	case Strategy::Auto: return "auto";
+	case Strategy::Serial: return "serial";
+	case Strategy::StdParallel: return "std par_unseq";
+	case Strategy::SampleSort: return "samplesort";
+	case Strategy::MergeSort: return "mergesort";
+	}
+	return "?";
+}
+
+// first ascending, second descending when first is equal
+struct PairFirstAscSecondDesc {
+	bool operator()(const std::pair<int, int>& a, const std::pair<int, int>& b) const {
+		if (a.first != b.first) return a.first < b.first;
+		return a.second > b.second;
+	}
+};
+
+constexpr bool hasStdParallel = PSORT_HAS_STD_EXECUTION != 0;
+
+// Below this many elements a parallel sort costs more than it saves.
+constexpr size_t SerialCutoff = size_t(1) << 16;
+
+namespace detail {
+
+template <typename It, typename Comp>
+void serialSort(It first, It last, Comp& comp, bool stable) {
+	if (stable) std::stable_sort(first, last, comp);
+	else std::sort(first, last, comp);
+}
+
+inline size_t tasksFor(ThreadPool& pool) {
+	return size_t(pool.size()) + 1; // parallel_for also runs a chunk on the caller
+}
+
+// Number of elements taken from 'a' among the first k outputs of a stable merge of a[0,n) and b[0,m).
+template <typename ItA, typename ItB, typename Comp>
+size_t coRank(size_t k, ItA a, size_t n, ItB b, size_t m, Comp& comp) {
+	size_t lo = k > m ? k - m : 0;
+	size_t hi = std::min(k, n);
+	while (lo < hi) {
+		size_t i = lo + (hi - lo) / 2;
+		// a[i] is still among the first k outputs if it does not sort after b[k - i - 1]
+		if (!comp(b[k - i - 1], a[i])) lo = i + 1;
+		else hi = i;
+	}
+	return lo;
+}
+
+// One merge round: runs [bounds[r], bounds[r+1]) of src are merged pairwise into dst.
+// Every merge is cut into output pieces of about 'piece' elements so all threads stay busy.
+template <typename Src, typename Dst, typename Comp>
+void mergeRound(Src src, Dst dst, const std::vector<size_t>& bounds, size_t piece, Comp& comp, ThreadPool& pool) {
+	struct Job { size_t a, mid, b, outLo, outHi; };
+	std::vector<Job> jobs;
+	size_t runs = bounds.size() - 1;
+	for (size_t r = 0; r < runs; r += 2) {
+		size_t a = bounds[r];
+		size_t mid = bounds[std::min(r + 1, runs)];
+		size_t b = bounds[std::min(r + 2, runs)];
+		for (size_t lo = a; lo < b; lo += piece) jobs.push_back({ a, mid, b, lo, std::min(b, lo + piece) });
+	}
+	pool.parallel_for(0, jobs.size(), 1, [&](size_t jb, size_t je) {
+		for (size_t j = jb; j < je; j++) {
+			const Job& job = jobs[j];
+			size_t n = job.mid - job.a, m = job.b - job.mid;
+			size_t k0 = job.outLo - job.a, k1 = job.outHi - job.a;
+			size_t i0 = coRank(k0, src + job.a, n, src + job.mid, m, comp);
+			size_t i1 = coRank(k1, src + job.a, n, src + job.mid, m, comp);
+			std::merge(std::make_move_iterator(src + job.a + i0), std::make_move_iterator(src + job.a + i1),
+				std::make_move_iterator(src + job.mid + (k0 - i0)), std::make_move_iterator(src + job.mid + (k1 - i1)),
+				dst + job.outLo, comp);
+		}
+	});
+}
+
+template <typename It, typename Comp>
+void mergeSort(It first, It last, Comp& comp, bool stable, ThreadPool& pool) {
+	using T = typename std::iterator_traits<It>::value_type;
+	size_t n = static_cast<size_t>(last - first);
+	size_t tasks = tasksFor(pool);
+	size_t runs = std::min(tasks * 2, std::max<size_t>(1, n / (SerialCutoff / 4)));
+	std::vector<size_t> bounds(runs + 1);
+	for (size_t r = 0; r <= runs; r++) bounds[r] = n * r / runs;
+
+	pool.parallel_for(0, runs, 1, [&](size_t rb, size_t re) {
+		for (size_t r = rb; r < re; r++) serialSort(first + bounds[r], first + bounds[r + 1], comp, stable);
+	});
+	if (runs == 1) return;
+
+	std::vector<T> buf(n);
+	size_t piece = std::max<size_t>(SerialCutoff / 4, n / (tasks * 2));
+	bool inBuf = false;
+	while (bounds.size() > 2) {
+		if (inBuf) mergeRound(buf.begin(), first, bounds, piece, comp, pool);
+		else mergeRound(first, buf.begin(), bounds, piece, comp, pool);
+		inBuf = !inBuf;
+		std::vector<size_t> next;
+		for (size_t r = 0; r + 1 < bounds.size(); r += 2) next.push_back(bounds[r]);
+		next.push_back(n);
+		bounds.swap(next);
+	}
+	if (inBuf) {
+		pool.parallel_for(0, n, SerialCutoff, [&](size_t lo, size_t hi) {
+			std::move(buf.begin() + lo, buf.begin() + hi, first + lo);
+		});
+	}
+}
+
+// Returns false (and leaves the input alone) if the sample has too few distinct splitters
+// to spread the keys, e.g. 100M values drawn from 10 distinct keys. The caller then merge sorts.
+template <typename It, typename Comp>
+bool sampleSort(It first, It last, Comp& comp, bool stable, ThreadPool& pool) {
+	using T = typename std::iterator_traits<It>::value_type;
+	size_t n = static_cast<size_t>(last - first);
+	size_t tasks = tasksFor(pool);
+	size_t buckets = std::min<size_t>(tasks * 4, std::max<size_t>(2, n / (SerialCutoff / 4)));
+	const size_t oversample = 32;
+
+	std::vector<T> sample;
+	sample.reserve(buckets * oversample);
+	uint64_t rng = 0x9E3779B97F4A7C15ull ^ n;
+	for (size_t i = 0; i < buckets * oversample; i++) {
+		rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; // xorshift64
+		sample.push_back(first[rng % n]);
+	}
+	std::sort(sample.begin(), sample.end(), comp);
+	std::vector<T> splitters;
+	for (size_t b = 1; b < buckets; b++) {
+		const T& s = sample[b * oversample];
+		if (splitters.empty() || comp(splitters.back(), s)) splitters.push_back(s);
+	}
+	if (splitters.size() < (buckets - 1) / 2) return false;
+	buckets = splitters.size() + 1;
+
+	auto bucketOf = [&](const T& x) {
+		return static_cast<size_t>(std::upper_bound(splitters.begin(), splitters.end(), x, comp) - splitters.begin());
+	};
+
+	// count per (block, bucket); blocks are contiguous so the scatter below stays stable
+	size_t blocks = tasks;
+	std::vector<size_t> counts(blocks * buckets, 0);
+	auto blockBegin = [&](size_t blk) { return n * blk / blocks; };
+	pool.parallel_for(0, blocks, 1, [&](size_t bb, size_t be) {
+		for (size_t blk = bb; blk < be; blk++) {
+			size_t* c = &counts[blk * buckets];
+			for (size_t i = blockBegin(blk); i < blockBegin(blk + 1); i++) c[bucketOf(first[i])]++;
+		}
+	});
+
+	// exclusive prefix sum, bucket-major: bucket 0 of every block, then bucket 1, ...
+	std::vector<size_t> bucketStart(buckets + 1, 0);
+	size_t pos = 0;
+	for (size_t b = 0; b < buckets; b++) {
+		bucketStart[b] = pos;
+		for (size_t blk = 0; blk < blocks; blk++) {
+			size_t c = counts[blk * buckets + b];
+			counts[blk * buckets + b] = pos;
+			pos += c;
+		}
+	}
+	bucketStart[buckets] = n;
+
+	std::vector<T> buf(n);
+	pool.parallel_for(0, blocks, 1, [&](size_t bb, size_t be) {
+		for (size_t blk = bb; blk < be; blk++) {
+			size_t* out = &counts[blk * buckets];
+			for (size_t i = blockBegin(blk); i < blockBegin(blk + 1); i++) {
+				buf[out[bucketOf(first[i])]++] = std::move(first[i]);
+			}
+		}
+	});
+
+	pool.parallel_for(0, buckets, 1, [&](size_t bb, size_t be) {
+		for (size_t b = bb; b < be; b++) {
+			auto lo = buf.begin() + bucketStart[b], hi = buf.begin() + bucketStart[b + 1];
+			serialSort(lo, hi, comp, stable);
+			std::move(lo, hi, first + bucketStart[b]);
+		}
+	});
+	return true;
+}
+
+template <typename It, typename Comp>
+void run(It first, It last, Comp comp, Strategy strategy, bool stable, ThreadPool& pool) {
+	size_t n = static_cast<size_t>(last - first);
+	if (n < 2) return;
+
+	if (strategy == Strategy::Auto) {
+		if (n < SerialCutoff || pool.size() < 2) {
+			strategy = Strategy::Serial;
+		} else {
+			if (std::is_sorted(first, last, comp)) return;
+			// strictly descending has no equal neighbours, so reversing is also stable
+			if (std::adjacent_find(first, last, [&](const auto& a, const auto& b) { return !comp(b, a); }) == last) {
+				std::reverse(first, last);
+				return;
+			}
+			strategy = hasStdParallel ? Strategy::StdParallel : Strategy::SampleSort;
+		}
+	}
+
+	switch (strategy) {
+	case Strategy::StdParallel:
+#if PSORT_HAS_STD_EXECUTION
+		if (stable) std::stable_sort(std::execution::par_unseq, first, last, comp);
+		else std::sort(std::execution::par_unseq, first, last, comp);
+		return;
+#else
+		[[fallthrough]];
+#endif
+	case Strategy::SampleSort:
+		if (n >= SerialCutoff && sampleSort(first, last, comp, stable, pool)) return;
+		[[fallthrough]];
+	case Strategy::MergeSort:
+		if (n >= SerialCutoff) {
+			mergeSort(first, last, comp, stable, pool);
+			return;
+		}
+		[[fallthrough]];
+	default:
+		serialSort(first, last, comp, stable);
+	}
+}
+
+} // namespace detail
+
+template <typename It, typename Comp = std::less<>>
+void sort(It first, It last, Comp comp = {}, Strategy strategy = Strategy::Auto, ThreadPool& pool = ThreadPool::instance()) {
+	detail::run(first, last, comp, strategy, false, pool);
+}
+
+// Equal elements keep their input order.
+template <typename It, typename Comp = std::less<>>
+void stableSort(It first, It last, Comp comp = {}, Strategy strategy = Strategy::Auto, ThreadPool& pool = ThreadPool::instance()) {
+	detail::run(first, last, comp, strategy, true, pool);
+}
+
+} // namespace psort
@@ -0,0 +1,101 @@
+// Benchmark: psort strategies against std::sort on ints and std::pair<int,int>.
+// usage: parallel_sort_bench [max n=10000000] [reps=1]
+//        (pass 100000000 for the 100M row; pairs need ~1.6 GB at that size)
+// build: g++ -O2 -std=c++20 parallel_sort_bench.cpp -pthread -ltbb
+//        (or add -DPSORT_NO_STD_EXECUTION when TBB is not installed)
+//
+// Inputs: random ints, random pairs (few distinct .first values, so the .second tie-break matters),
+// already sorted ints and reversed ints. Every result is checked with std::is_sorted, and the
+// stable variants are checked against std::stable_sort.
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <functional>
+#include <cstdio>
+#include "parallel_sort.h"
+#include "../../common/bench_util.h"
+
+template <typename T>
+using Input = std::function<std::vector<T>(size_t)>;
+
+std::vector<int> randomInts(size_t n) {
+	std::mt19937 rng(42);
+	std::vector<int> v(n);
+	for (auto& x : v) x = static_cast<int>(rng());
+	return v;
+}
+
+std::vector<int> sortedInts(size_t n) {
+	std::vector<int> v(n);
+	for (size_t i = 0; i < n; i++) v[i] = static_cast<int>(i) - static_cast<int>(n / 2);
+	return v;
+}
+
+std::vector<int> reversedInts(size_t n) {
+	std::vector<int> v = sortedInts(n);
+	std::reverse(v.begin(), v.end());
+	return v;
+}
+
+std::vector<std::pair<int, int>> randomPairs(size_t n) {
+	std::mt19937 rng(7);
+	std::vector<std::pair<int, int>> v(n);
+	int firsts = static_cast<int>(std::max<size_t>(1, n / 16));
+	for (auto& p : v) p = { static_cast<int>(rng() % firsts), static_cast<int>(rng()) };
+	return v;
+}
+
+template <typename T, typename Comp>
+void runInput(const char* label, size_t n, int reps, const Input<T>& make, Comp comp) {
+	std::vector<T> original = make(n);
+	std::vector<T> expectStable = original;
+	std::stable_sort(expectStable.begin(), expectStable.end(), comp);
+
+	struct Variant { const char* name; bool stable; psort::Strategy strategy; bool plainStd; };
+	const Variant variants[] = {
+		{ "std::sort", false, psort::Strategy::Serial, true },
+		{ "std::sort par_unseq", false, psort::Strategy::StdParallel, false },
+		{ "samplesort", false, psort::Strategy::SampleSort, false },
+		{ "mergesort", false, psort::Strategy::MergeSort, false },
+		{ "auto", false, psort::Strategy::Auto, false },
+		{ "std::stable_sort", true, psort::Strategy::Serial, true },
+		{ "stable par_unseq", true, psort::Strategy::StdParallel, false },
+		{ "stable samplesort", true, psort::Strategy::SampleSort, false },
+		{ "stable mergesort", true, psort::Strategy::MergeSort, false },
+	};
+
+	double baseline = 0;
+	for (const Variant& v : variants) {
+		if (v.strategy == psort::Strategy::StdParallel && !psort::hasStdParallel) continue;
+		double best = 1e30;
+		bool ok = true;
+		for (int r = 0; r < reps; r++) {
+			std::vector<T> data = original;
+			bench::Stopwatch sw;
+			if (v.stable) psort::stableSort(data.begin(), data.end(), comp, v.strategy);
+			else psort::sort(data.begin(), data.end(), comp, v.strategy);
+			best = std::min(best, sw.seconds());
+			ok = ok && (v.stable ? data == expectStable : std::is_sorted(data.begin(), data.end(), comp));
+		}
+		if (v.plainStd && !v.stable) baseline = best;
+		std::printf("  %-8s %-12s %-20s %9.1f ms  %7.1f M/s  x%.2f%s\n", label, std::to_string(n).c_str(), v.name,
+			best * 1e3, n / best / 1e6, baseline / best, ok ? "" : "  WRONG ORDER");
+	}
+}
+
+int main(int argc, char** argv) {
+	size_t maxN = static_cast<size_t>(bench::argOr(argc, argv, 1, 10000000));
+	int reps = static_cast<int>(bench::argOr(argc, argv, 2, 1));
+	std::printf("threads in pool: %u, std::execution backend: %s\n", ThreadPool::instance().size(),
+		psort::hasStdParallel ? "yes" : "no");
+	std::printf("  %-8s %-12s %-20s %12s  %11s  %s\n", "input", "n", "variant", "time", "rate", "vs std::sort");
+
+	for (size_t n = 1000000; n <= maxN; n *= 10) {
+		runInput<int>("random", n, reps, randomInts, std::less<>{});
+		runInput<int>("sorted", n, reps, sortedInts, std::less<>{});
+		runInput<int>("reversed", n, reps, reversedInts, std::less<>{});
+		runInput<std::pair<int, int>>("pairs", n, reps, randomPairs, psort::PairFirstAscSecondDesc{});
+	}
+	return 0;
+}
@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "../../common/thread_pool.h"
+
+/*
+Enumerating the n! permutations of n elements, split over threads.
+ - std::next_permutation walks them in lexicographic order, one after the other: the k-th
+   permutation is only known after the k-1 before it, so the loop cannot be split.
+ - Lehmer code: the k-th lexicographic permutation of 0..n-1 has the factorial-base digits of k as
+   "how many smaller unused elements come before it" at every position. So rank() (permutation -> k)
+   and unrank() (k -> permutation) are O(n) / O(n^2) with n <= 20, and [0, n!) can be cut into
+   ranges that start anywhere: unrank the first rank, then next_permutation inside the range.
+ - forEachInRange() enumerates one rank range; parallelForRanges() / parallelForEach() hand ranges
+   to the ThreadPool. Per-range callbacks are where results get combined without locks.
+ - HeapPermutations: Heap's algorithm, the next permutation is always exactly one swap (next_permutation
+   does a reverse of a suffix as well, ~1.5 swaps + a scan on average), and the swapped positions are
+   reported, so a cost function can be updated in O(1) instead of recomputed in O(n). Its order is not
+   lexicographic; parallelHeap() splits it by fixing the last few elements per task instead.
+ - Elements are indices 0..n-1 (uint8_t); map them to real items (letters, cities) through an array.
+   Distinct elements only: for multisets std::next_permutation skips repeats, these do not.
+ - n <= 20, because 21! does not fit in uint64_t.
+*/
+namespace perm {
+
+constexpr size_t MaxN = 20;
+
+using Perm = std::array<uint8_t, MaxN>;
+
+inline uint64_t factorial(size_t n) {
+	if (n > MaxN) throw std::out_of_range("perm: n! only fits in 64 bits for n <= 20");
+	uint64_t f = 1;
+	for (size_t i = 2; i <= n; i++) f *= i;
+	return f;
+}
+
+// Lexicographic rank of a permutation of 0..n-1 (n = p.size()).
+inline uint64_t rank(std::span<const uint8_t> p) {
+	size_t n = p.size();
+	uint64_t r = 0;
+	uint32_t used = 0;
+	for (size_t i = 0; i < n; i++) {
+		uint32_t below = (1u << p[i]) - 1;
+		uint64_t digit = p[i] - static_cast<uint64_t>(std::popcount(used & below)); // smaller elements still unused
+		r = r * (n - i) + digit; // Horner over the factorial base
+		used |= 1u << p[i];
+	}
+	return r;
+}
+
+// Writes the permutation of 0..n-1 with lexicographic rank r (r < n!) to out[0..n).
+inline void unrank(uint64_t r, size_t n, uint8_t* out) {
+	if (n > MaxN) throw std::out_of_range("perm: n <= 20");
+	std::array<uint8_t, MaxN> digits{};
+	for (size_t i = n; i-- > 0;) { // least significant digit has radix 1, then 2, 3, ...
+		uint64_t radix = n - i;
+		digits[i] = static_cast<uint8_t>(r % radix);
+		r /= radix;
+	}
+	std::array<uint8_t, MaxN> unused{};
+	std::iota(unused.begin(), unused.begin() + n, uint8_t{ 0 });
+	for (size_t i = 0; i < n; i++) {
+		out[i] = unused[digits[i]];
+		std::copy(unused.begin() + digits[i] + 1, unused.begin() + (n - i), unused.begin() + digits[i]);
+	}
+}
+
+// fn(std::span<const uint8_t> perm) for the permutations of 0..n-1 with ranks in [first, last), in order.
+template <typename Fn>
+void forEachInRange(size_t n, uint64_t first, uint64_t last, Fn&& fn) {
+	if (first >= last) return;
+	Perm p{};
+	unrank(first, n, p.data());
+	std::span<const uint8_t> view(p.data(), n);
+	for (uint64_t r = first;;) {
+		fn(view);
+		if (++r == last) break;
+		std::next_permutation(p.begin(), p.begin() + n);
+	}
+}
+
+// Splits [0, n!) into rank ranges and calls fn(first, last) for each on the pool (calls run concurrently).
+// The pool only splits size_t ranges, and 13! already passes 2^32: it gets chunk numbers, the 64-bit
+// rank bounds are computed per chunk.
+template <typename Fn>
+void parallelForRanges(size_t n, ThreadPool& pool, Fn&& fn, size_t minRange = 1 << 12) {
+	uint64_t total = factorial(n);
+	uint64_t chunks = std::min<uint64_t>(pool.size() + 1, std::max<uint64_t>(1, total / std::max<size_t>(1, minRange)));
+	uint64_t step = (total + chunks - 1) / chunks;
+	pool.parallel_for(0, static_cast<size_t>(chunks), 1, [&](size_t lo, size_t hi) {
+		for (size_t c = lo; c < hi; c++) {
+			uint64_t first = c * step, last = std::min(total, first + step);
+			if (first < last) fn(first, last);
+		}
+	});
+}
+
+// fn(perm) for every permutation of 0..n-1; calls from different threads run concurrently.
+template <typename Fn>
+void parallelForEach(size_t n, ThreadPool& pool, Fn&& fn) {
+	parallelForRanges(n, pool, [&](uint64_t first, uint64_t last) { forEachInRange(n, first, last, fn); });
+}
+
+// Heap's algorithm (iterative): every next() is one swap of two positions.
+template <typename T>
+class HeapPermutations {
+private:
+	std::span<T> items_;
+	std::array<uint32_t, MaxN> counter_{};
+	size_t level_ = 1;
+	size_t swapA_ = 0, swapB_ = 0;
+
+public:
+	explicit HeapPermutations(std::span<T> items) : items_(items) {
+		if (items.size() > MaxN) throw std::out_of_range("perm: n <= 20");
+	}
+
+	// Moves items to the next permutation; false (and items unchanged) once all n! have been visited.
+	bool next() {
+		size_t n = items_.size();
+		while (level_ < n) {
+			if (counter_[level_] < level_) {
+				swapA_ = (level_ & 1) ? counter_[level_] : 0;
+				swapB_ = level_;
+				std::swap(items_[swapA_], items_[swapB_]);
+				counter_[level_]++;
+				level_ = 1;
+				return true;
+			}
+			counter_[level_] = 0;
+			level_++;
+		}
+		return false;
+	}
+
+	// Positions exchanged by the last next().
+	size_t swappedA() const { return swapA_; }
+	size_t swappedB() const { return swapB_; }
+};
+
+// Runs Heap's algorithm over all permutations of items, split into tasks that each fix the last few
+// positions. fn(std::span<T> perm, HeapPermutations<T>& gen) is called once per task with the task's
+// first permutation; it walks the rest with gen.next() (which permutes the first perm.size() - fixed
+// positions of perm in place), so per-task state can live in locals. Tasks run concurrently, each on
+// its own copy of items.
+template <typename T, typename Fn>
+void parallelHeap(std::span<const T> items, ThreadPool& pool, Fn&& fn) {
+	size_t n = items.size();
+	if (n > MaxN) throw std::out_of_range("perm: n <= 20");
+	// fix as many trailing positions as needed for a few tasks per thread
+	size_t fixed = 0;
+	uint64_t tasks = 1;
+	while (fixed + 2 < n && tasks < 8 * (static_cast<uint64_t>(pool.size()) + 1)) tasks *= n - fixed++;
+	pool.parallel_for(0, static_cast<size_t>(tasks), 1, [&](size_t lo, size_t hi) {
+		std::vector<T> work(n);
+		for (size_t t = lo; t < hi; t++) {
+			// task number -> which unused element goes to position n-1, n-2, ... (mixed radix)
+			std::array<uint8_t, MaxN> unused{};
+			std::iota(unused.begin(), unused.begin() + n, uint8_t{ 0 });
+			size_t left = n;
+			uint64_t code = t;
+			for (size_t f = 0; f < fixed; f++) {
+				size_t pick = static_cast<size_t>(code % left);
+				code /= left;
+				work[n - 1 - f] = items[unused[pick]];
+				unused[pick] = unused[--left];
+			}
+			for (size_t i = 0; i < left; i++) work[i] = items[unused[i]];
+			std::span<T> perm(work);
+			HeapPermutations<T> gen(perm.first(left));
+			fn(perm, gen);
+		}
+	});
+}
+
+} // namespace perm
@@ -0,0 +1,128 @@
+// Benchmark: permutations per second - std::next_permutation vs Lehmer-ranked ranges vs Heap's
+// algorithm, serial and on 1..max threads; plus rank/unrank speed.
+// usage: permutations_bench [n=11] [max threads=hardware]
+//
+// The work per permutation is counting derangements (no element at its own index), so every
+// method can be checked against D(n) = (n - 1) * (D(n-1) + D(n-2)).
+//   next_permutation : the loop from algorithms.cpp, fixed points counted in O(n) per permutation
+//   ranges           : perm::forEachInRange over [0, n!), same O(n) count
+//   Heap's, O(1)     : perm::HeapPermutations, the fixed-point count updated from the swapped pair
+// The parallel rows use a ThreadPool of t-1 workers (the calling thread is the t-th).
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <cstdio>
+#include "permutations.h"
+#include "../../common/bench_util.h"
+
+uint64_t derangements(size_t n) {
+	uint64_t a = 1, b = 0; // D(0), D(1)
+	if (n == 0) return a;
+	for (size_t i = 2; i <= n; i++) {
+		uint64_t c = (i - 1) * (a + b);
+		a = b;
+		b = c;
+	}
+	return b;
+}
+
+inline size_t fixedPoints(std::span<const uint8_t> p) {
+	size_t f = 0;
+	for (size_t i = 0; i < p.size(); i++) f += p[i] == i;
+	return f;
+}
+
+// Fixed points after positions a and b were swapped, from the count before.
+inline size_t afterSwap(size_t fixedBefore, std::span<const uint8_t> p, size_t a, size_t b) {
+	// before the swap, position a held p[b] and b held p[a]
+	return fixedBefore - (p[b] == a) - (p[a] == b) + (p[a] == a) + (p[b] == b);
+}
+
+int main(int argc, char** argv) {
+	size_t n = static_cast<size_t>(bench::argOr(argc, argv, 1, 11));
+	unsigned maxThreads = static_cast<unsigned>(bench::argOr(argc, argv, 2, std::max(1u, std::thread::hardware_concurrency())));
+	uint64_t total = perm::factorial(n), expect = derangements(n);
+	std::printf("n = %zu: %llu permutations, %llu derangements; M permutations/s\n", n,
+		static_cast<unsigned long long>(total), static_cast<unsigned long long>(expect));
+	auto report = [&](const char* name, double sec, uint64_t got, double perCore = 0) {
+		std::printf("%-28s %9.1f", name, total / sec / 1e6);
+		if (perCore > 0) std::printf("  (%.1f per thread)", perCore);
+		std::printf("%s\n", got == expect ? "" : "  WRONG COUNT");
+	};
+
+	{
+		std::vector<uint8_t> p(n);
+		std::iota(p.begin(), p.end(), uint8_t{ 0 });
+		bench::Stopwatch sw;
+		uint64_t count = 0;
+		do count += fixedPoints(p) == 0; while (std::next_permutation(p.begin(), p.end()));
+		report("std::next_permutation", sw.seconds(), count);
+	}
+	{
+		bench::Stopwatch sw;
+		uint64_t count = 0;
+		perm::forEachInRange(n, 0, total, [&](std::span<const uint8_t> p) { count += fixedPoints(p) == 0; });
+		report("ranges (serial)", sw.seconds(), count);
+	}
+	{
+		std::vector<uint8_t> p(n);
+		std::iota(p.begin(), p.end(), uint8_t{ 0 });
+		bench::Stopwatch sw;
+		size_t fixed = n;
+		uint64_t count = fixed == 0;
+		perm::HeapPermutations<uint8_t> gen(p);
+		while (gen.next()) {
+			fixed = afterSwap(fixed, p, gen.swappedA(), gen.swappedB());
+			count += fixed == 0;
+		}
+		report("Heap's, O(1) update", sw.seconds(), count);
+	}
+
+	for (unsigned t = 1; t <= maxThreads; t *= 2) {
+		ThreadPool pool(t - 1);
+		std::atomic<uint64_t> count{ 0 };
+		bench::Stopwatch sw;
+		perm::parallelForRanges(n, pool, [&](uint64_t first, uint64_t last) {
+			uint64_t local = 0;
+			perm::forEachInRange(n, first, last, [&](std::span<const uint8_t> p) { local += fixedPoints(p) == 0; });
+			count += local;
+		});
+		double sec = sw.seconds();
+		char name[64];
+		std::snprintf(name, sizeof(name), "ranges, t=%u", t);
+		report(name, sec, count, total / sec / 1e6 / t);
+
+		count = 0;
+		sw.reset();
+		std::vector<uint8_t> items(n);
+		std::iota(items.begin(), items.end(), uint8_t{ 0 });
+		perm::parallelHeap<uint8_t>(items, pool, [&](std::span<uint8_t> p, perm::HeapPermutations<uint8_t>& gen) {
+			size_t fixed = fixedPoints(p);
+			uint64_t local = fixed == 0;
+			while (gen.next()) {
+				fixed = afterSwap(fixed, p, gen.swappedA(), gen.swappedB());
+				local += fixed == 0;
+			}
+			count += local;
+		});
+		sec = sw.seconds();
+		std::snprintf(name, sizeof(name), "Heap's, t=%u", t);
+		report(name, sec, count, total / sec / 1e6 / t);
+	}
+
+	// rank / unrank round trips
+	std::mt19937_64 rng(50);
+	std::vector<uint64_t> ranks(1000000);
+	for (auto& r : ranks) r = rng() % total;
+	perm::Perm p{};
+	bool ok = true;
+	bench::Stopwatch sw;
+	for (uint64_t r : ranks) {
+		perm::unrank(r, n, p.data());
+		ok &= perm::rank(std::span<const uint8_t>(p.data(), n)) == r;
+	}
+	std::printf("rank(unrank(r)) round trip: %.1f ns%s\n", sw.nanos() / ranks.size(), ok ? "" : "  MISMATCH");
+	return 0;
+}
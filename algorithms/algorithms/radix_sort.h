@@ -0,0 +1,205 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../../common/thread_pool.h"
+
+/*
+LSD radix sort for integer keys.
+ - Any order that is "compare some integers in a fixed order" is just one big unsigned key:
+     signed int             -> flip the sign bit (INT_MIN becomes 0, -1 becomes 0x7FFFFFFF, 0 becomes 0x80000000)
+     pair (first asc, second desc), the comp() order in algorithms.cpp
+                            -> (flipped first << 32) | ~(flipped second)
+   and sorting that key ascending with no comparator at all gives the same result as std::sort(p, p+n, comp).
+ - One pass per 8-bit digit: histogram -> prefix sum -> scatter into a second buffer. Each pass is
+   stable, so after the last (most significant) digit everything is in order. O(n * passes).
+ - Skip-pass detection: histograms for every digit are taken in a single read up front. When one
+   digit value holds all n elements (top bytes of small ints, .first values in a small range) that
+   pass would copy the data unchanged, so it is skipped.
+ - parallelSortByKey : the same passes with the array cut into blocks on the ThreadPool.
+   Per block histograms give every block its own write offset inside each bucket, so the scatter
+   needs no atomics and stays stable.
+*/
+namespace radix {
+
+constexpr unsigned DigitBits = 8;
+constexpr size_t Buckets = size_t(1) << DigitBits;
+
+// Integer -> unsigned key with the same ascending order.
+template <typename I>
+constexpr auto orderedKey(I x) {
+	static_assert(std::is_integral_v<I>, "orderedKey needs an integer");
+	using U = std::make_unsigned_t<I>;
+	if constexpr (std::is_signed_v<I>) return static_cast<U>(static_cast<U>(x) ^ (U(1) << (sizeof(U) * 8 - 1)));
+	else return static_cast<U>(x);
+}
+
+// first ascending, second descending on ties
+struct PairFirstAscSecondDescKey {
+	uint64_t operator()(const std::pair<int, int>& p) const {
+		return (uint64_t(orderedKey(p.first)) << 32) | uint32_t(~orderedKey(p.second));
+	}
+};
+
+struct IdentityKey {
+	template <typename I>
+	auto operator()(I x) const { return orderedKey(x); }
+};
+
+namespace detail {
+
+template <typename Key>
+constexpr unsigned passesFor() { return sizeof(Key) * 8 / DigitBits; }
+
+template <typename Key>
+inline size_t digitOf(Key k, unsigned pass) { return static_cast<size_t>((k >> (pass * DigitBits)) & (Buckets - 1)); }
+
+template <typename It, typename KeyFn, typename Key>
+void countAllDigits(It first, size_t lo, size_t hi, KeyFn& key, std::array<size_t, Buckets>* hist) {
+	for (size_t i = lo; i < hi; i++) {
+		Key k = key(first[i]);
+		for (unsigned p = 0; p < passesFor<Key>(); p++) hist[p][digitOf(k, p)]++;
+	}
+}
+
+// A pass can be skipped when every element has the same digit there.
+inline bool trivialPass(const std::array<size_t, Buckets>& h, size_t n) {
+	return std::find(h.begin(), h.end(), n) != h.end();
+}
+
+} // namespace detail
+
+template <typename It, typename KeyFn>
+void sortByKey(It first, It last, KeyFn key) {
+	using T = typename std::iterator_traits<It>::value_type;
+	using Key = std::invoke_result_t<KeyFn&, const T&>;
+	static_assert(std::is_unsigned_v<Key>, "the key function must return an unsigned integer");
+	constexpr unsigned Passes = detail::passesFor<Key>();
+
+	size_t n = static_cast<size_t>(last - first);
+	if (n < 2) return;
+
+	std::array<std::array<size_t, Buckets>, Passes> hist{};
+	detail::countAllDigits<It, KeyFn, Key>(first, 0, n, key, hist.data());
+
+	std::vector<T> buf;
+	bool inBuf = false;
+	for (unsigned p = 0; p < Passes; p++) {
+		if (detail::trivialPass(hist[p], n)) continue;
+		if (buf.empty()) buf.resize(n);
+		std::array<size_t, Buckets> offset;
+		size_t sum = 0;
+		for (size_t b = 0; b < Buckets; b++) { offset[b] = sum; sum += hist[p][b]; }
+
+		auto scatter = [&](auto src, auto dst) {
+			for (size_t i = 0; i < n; i++) {
+				size_t d = detail::digitOf(key(src[i]), p);
+				dst[offset[d]++] = std::move(src[i]);
+			}
+		};
+		if (inBuf) scatter(buf.begin(), first);
+		else scatter(first, buf.begin());
+		inBuf = !inBuf;
+	}
+	if (inBuf) std::move(buf.begin(), buf.end(), first);
+}
+
+template <typename It, typename KeyFn>
+void parallelSortByKey(It first, It last, KeyFn key, ThreadPool& pool = ThreadPool::instance()) {
+	using T = typename std::iterator_traits<It>::value_type;
+	using Key = std::invoke_result_t<KeyFn&, const T&>;
+	static_assert(std::is_unsigned_v<Key>, "the key function must return an unsigned integer");
+	constexpr unsigned Passes = detail::passesFor<Key>();
+	using Hist = std::array<size_t, Buckets>;
+
+	size_t n = static_cast<size_t>(last - first);
+	size_t blocks = std::min<size_t>(pool.size() + 1, n / (size_t(1) << 16));
+	if (blocks < 2) {
+		sortByKey(first, last, key);
+		return;
+	}
+	auto blockBegin = [&](size_t blk) { return n * blk / blocks; };
+
+	// all digit histograms in one read; the totals decide which passes to skip
+	std::vector<std::array<Hist, Passes>> perBlock(blocks, std::array<Hist, Passes>{});
+	pool.parallel_for(0, blocks, 1, [&](size_t bb, size_t be) {
+		for (size_t blk = bb; blk < be; blk++) {
+			detail::countAllDigits<It, KeyFn, Key>(first, blockBegin(blk), blockBegin(blk + 1), key, perBlock[blk].data());
+		}
+	});
+	std::array<Hist, Passes> total{};
+	for (size_t blk = 0; blk < blocks; blk++)
+		for (unsigned p = 0; p < Passes; p++)
+			for (size_t b = 0; b < Buckets; b++) total[p][b] += perBlock[blk][p][b];
+
+	std::vector<T> buf;
+	std::vector<Hist> offset(blocks);
+	bool inBuf = false;
+	bool firstPass = true;
+	for (unsigned p = 0; p < Passes; p++) {
+		if (detail::trivialPass(total[p], n)) continue;
+		if (buf.empty()) buf.resize(n);
+
+		auto run = [&](auto src, auto dst) {
+			// block histograms from the up-front read are only valid while the data is in input order
+			if (!firstPass) {
+				pool.parallel_for(0, blocks, 1, [&](size_t bb, size_t be) {
+					for (size_t blk = bb; blk < be; blk++) {
+						Hist& h = perBlock[blk][p];
+						h.fill(0);
+						for (size_t i = blockBegin(blk); i < blockBegin(blk + 1); i++) h[detail::digitOf(key(src[i]), p)]++;
+					}
+				});
+			}
+			size_t sum = 0;
+			for (size_t b = 0; b < Buckets; b++) {
+				for (size_t blk = 0; blk < blocks; blk++) {
+					offset[blk][b] = sum;
+					sum += perBlock[blk][p][b];
+				}
+			}
+			pool.parallel_for(0, blocks, 1, [&](size_t bb, size_t be) {
+				for (size_t blk = bb; blk < be; blk++) {
+					Hist& out = offset[blk];
+					for (size_t i = blockBegin(blk); i < blockBegin(blk + 1); i++) {
+						size_t d = detail::digitOf(key(src[i]), p);
+						dst[out[d]++] = std::move(src[i]);
+					}
+				}
+			});
+		};
+		if (inBuf) run(buf.begin(), first);
+		else run(first, buf.begin());
+		inBuf = !inBuf;
+		firstPass = false;
+	}
+	if (inBuf) {
+		pool.parallel_for(0, n, size_t(1) << 16, [&](size_t lo, size_t hi) {
+			std::move(buf.begin() + lo, buf.begin() + hi, first + lo);
+		});
+	}
+}
+
+// Signed or unsigned integers, ascending.
+template <typename It>
+void sort(It first, It last) { sortByKey(first, last, IdentityKey{}); }
+
+template <typename It>
+void parallelSort(It first, It last, ThreadPool& pool = ThreadPool::instance()) {
+	parallelSortByKey(first, last, IdentityKey{}, pool);
+}
+
+// Same order as std::sort(p, p + n, comp) with comp() from algorithms.cpp.
+template <typename It>
+void sortPairsFirstAscSecondDesc(It first, It last) { sortByKey(first, last, PairFirstAscSecondDescKey{}); }
+
+template <typename It>
+void parallelSortPairsFirstAscSecondDesc(It first, It last, ThreadPool& pool = ThreadPool::instance()) {
+	parallelSortByKey(first, last, PairFirstAscSecondDescKey{}, pool);
+}
+
+} // namespace radix
@@ -0,0 +1,83 @@
+// Benchmark: LSD radix sort against std::sort with a comparator.
+// usage: radix_sort_bench [max n=10000000] [reps=3]
+//
+//  pairs full   : random .first and .second over the whole int range (8 passes, none skipped)
+//  pairs narrow : .first in [0, 1000), the algorithms.cpp shape; the top 2-3 bytes of .first never
+//                 change, so those passes are skipped
+//  ints         : random signed ints (4 passes)
+//  ints narrow  : values in [0, 256); only the low byte differs, the other 3 passes are skipped
+//
+// Every radix result is checked element by element against std::stable_sort with the comparator
+// (radix sort is stable, so the results must be identical, not just "sorted").
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdio>
+#include "radix_sort.h"
+#include "../../common/bench_util.h"
+
+// the comparator from algorithms.cpp: first ascending, second descending on ties
+bool comp(std::pair<int, int> p1, std::pair<int, int> p2) {
+	if (p1.first < p2.first) return true;
+	if (p1.first == p2.first) return p1.second > p2.second;
+	return false;
+}
+
+template <typename T, typename StdSort, typename Radix, typename ParRadix, typename Expect>
+void row(const char* label, const std::vector<T>& input, int reps, StdSort stdSort, Radix radixSort,
+	ParRadix parRadixSort, Expect expect) {
+	std::vector<T> expected = input;
+	expect(expected);
+
+	auto time = [&](auto&& fn, bool& ok) {
+		double best = 1e30;
+		for (int r = 0; r < reps; r++) {
+			std::vector<T> data = input;
+			bench::Stopwatch sw;
+			fn(data);
+			best = std::min(best, sw.seconds());
+			ok = ok && data == expected;
+		}
+		return best;
+	};
+	bool okStd = true, okRadix = true, okPar = true;
+	double tStd = time(stdSort, okStd);
+	double tRadix = time(radixSort, okRadix);
+	double tPar = time(parRadixSort, okPar);
+	size_t n = input.size();
+	std::printf("%-13s %11zu %10.1f %10.1f %10.1f   x%5.2f  x%5.2f%s\n", label, n, n / tStd / 1e6, n / tRadix / 1e6,
+		n / tPar / 1e6, tStd / tRadix, tStd / tPar, okStd && okRadix && okPar ? "" : "  MISMATCH");
+}
+
+int main(int argc, char** argv) {
+	size_t maxN = static_cast<size_t>(bench::argOr(argc, argv, 1, 10000000));
+	int reps = static_cast<int>(bench::argOr(argc, argv, 2, 3));
+	std::printf("threads in pool: %u, rates in M elements/s\n", ThreadPool::instance().size());
+	std::printf("%-13s %11s %10s %10s %10s   %6s  %6s\n", "input", "n", "std::sort", "radix", "par radix", "radix", "par");
+
+	using P = std::pair<int, int>;
+	auto stdPairs = [](std::vector<P>& v) { std::sort(v.begin(), v.end(), comp); };
+	auto stablePairs = [](std::vector<P>& v) { std::stable_sort(v.begin(), v.end(), comp); };
+	auto radixPairs = [](std::vector<P>& v) { radix::sortPairsFirstAscSecondDesc(v.begin(), v.end()); };
+	auto parPairs = [](std::vector<P>& v) { radix::parallelSortPairsFirstAscSecondDesc(v.begin(), v.end()); };
+	auto stdInts = [](std::vector<int>& v) { std::sort(v.begin(), v.end()); };
+	auto radixInts = [](std::vector<int>& v) { radix::sort(v.begin(), v.end()); };
+	auto parInts = [](std::vector<int>& v) { radix::parallelSort(v.begin(), v.end()); };
+
+	std::mt19937 rng(1234);
+	for (size_t n = 1000000; n <= maxN; n *= 10) {
+		std::vector<P> pairs(n);
+		for (auto& p : pairs) p = { static_cast<int>(rng()), static_cast<int>(rng()) };
+		row("pairs full", pairs, reps, stdPairs, radixPairs, parPairs, stablePairs);
+		for (auto& p : pairs) p = { static_cast<int>(rng() % 1000), static_cast<int>(rng()) };
+		row("pairs narrow", pairs, reps, stdPairs, radixPairs, parPairs, stablePairs);
+
+		std::vector<int> ints(n);
+		for (auto& x : ints) x = static_cast<int>(rng());
+		row("ints", ints, reps, stdInts, radixInts, parInts, stdInts);
+		for (auto& x : ints) x = static_cast<int>(rng() % 256);
+		row("ints narrow", ints, reps, stdInts, radixInts, parInts, stdInts);
+	}
+	return 0;
+}
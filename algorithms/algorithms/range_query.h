@@ -0,0 +1,165 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+#include "../../common/thread_pool.h"
+
+/*
+Range queries over an array, ranges are inclusive [lo, hi] like the "sum from i to j" loop in algorithms.cpp.
+                    build        query      point update   memory
+  naive loop        -            O(j-i)     O(1)           -
+  PrefixSum         O(n)         O(1)       O(n)           n
+  SparseTable       O(n log n)   O(1)       rebuild        n log n     (min/max only: overlap is harmless)
+  FenwickTree       O(n)         O(log n)   O(log n)       n           (sums)
+  SegmentTree       O(n)         O(log n)   O(log n)       2n          (any associative op: min/max/sum)
+ - Static data: PrefixSum for sums, SparseTable for min/max.
+ - Slowly changing data: FenwickTree for sums, SegmentTree for min/max.
+ - Sums are accumulated in a wider type (int64_t for int) so a long range cannot overflow.
+ - queryMany() answers a whole batch of ranges, split across the ThreadPool when it is large.
+*/
+namespace rq {
+
+struct Range {
+	size_t lo, hi; // inclusive
+};
+
+struct Min {
+	template <typename T> T operator()(const T& a, const T& b) const { return b < a ? b : a; }
+};
+struct Max {
+	template <typename T> T operator()(const T& a, const T& b) const { return a < b ? b : a; }
+};
+
+template <typename T, typename Acc = int64_t>
+class PrefixSum {
+private:
+	std::vector<Acc> prefix_; // prefix_[k] = a[0] + ... + a[k-1]
+public:
+	using value_type = Acc;
+	PrefixSum() = default;
+	explicit PrefixSum(std::span<const T> a) : prefix_(a.size() + 1) {
+		prefix_[0] = 0;
+		for (size_t k = 0; k < a.size(); k++) prefix_[k + 1] = prefix_[k] + static_cast<Acc>(a[k]);
+	}
+	size_t size() const { return prefix_.size() - 1; }
+	Acc query(size_t lo, size_t hi) const { return prefix_[hi + 1] - prefix_[lo]; }
+};
+
+// O(1) min or max: any range is covered by two (possibly overlapping) power-of-two windows.
+template <typename T, typename Op>
+class SparseTable {
+private:
+	std::vector<std::vector<T>> levels_; // levels_[k][i] = op over a[i, i + 2^k)
+	Op op_;
+public:
+	using value_type = T;
+	SparseTable() = default;
+	explicit SparseTable(std::span<const T> a, Op op = {}) : op_(op) {
+		levels_.emplace_back(a.begin(), a.end());
+		for (size_t k = 1; (size_t(1) << k) <= a.size(); k++) {
+			const std::vector<T>& prev = levels_[k - 1];
+			size_t half = size_t(1) << (k - 1);
+			std::vector<T> cur(a.size() - (size_t(1) << k) + 1);
+			for (size_t i = 0; i < cur.size(); i++) cur[i] = op_(prev[i], prev[i + half]);
+			levels_.push_back(std::move(cur));
+		}
+	}
+	size_t size() const { return levels_.empty() ? 0 : levels_[0].size(); }
+	T query(size_t lo, size_t hi) const {
+		unsigned k = std::bit_width(hi - lo + 1) - 1;
+		return op_(levels_[k][lo], levels_[k][hi + 1 - (size_t(1) << k)]);
+	}
+};
+
+template <typename T, typename Acc = int64_t>
+class FenwickTree {
+private:
+	std::vector<Acc> tree_; // 1-based
+	std::vector<T> values_;
+
+	Acc prefix(size_t count) const { // a[0] + ... + a[count-1]
+		Acc s = 0;
+		for (size_t i = count; i > 0; i &= i - 1) s += tree_[i];
+		return s;
+	}
+	void addToTree(size_t idx, Acc delta) {
+		for (size_t i = idx + 1; i < tree_.size(); i += i & (~i + 1)) tree_[i] += delta;
+	}
+public:
+	using value_type = Acc;
+	FenwickTree() = default;
+	explicit FenwickTree(std::span<const T> a) : tree_(a.size() + 1, 0), values_(a.begin(), a.end()) {
+		for (size_t i = 1; i <= a.size(); i++) {
+			tree_[i] += static_cast<Acc>(a[i - 1]);
+			size_t parent = i + (i & (~i + 1));
+			if (parent <= a.size()) tree_[parent] += tree_[i];
+		}
+	}
+	size_t size() const { return values_.size(); }
+	Acc query(size_t lo, size_t hi) const { return prefix(hi + 1) - prefix(lo); }
+	void add(size_t idx, T delta) {
+		values_[idx] += delta;
+		addToTree(idx, static_cast<Acc>(delta));
+	}
+	void set(size_t idx, T value) {
+		// the difference is taken in Acc: for int, value - old can overflow an int
+		addToTree(idx, static_cast<Acc>(value) - static_cast<Acc>(values_[idx]));
+		values_[idx] = value;
+	}
+};
+
+// Iterative bottom-up segment tree: leaves at [n, 2n), node i = op(node 2i, node 2i+1).
+template <typename T, typename Op>
+class SegmentTree {
+private:
+	std::vector<T> tree_;
+	size_t n_ = 0;
+	Op op_;
+public:
+	using value_type = T;
+	SegmentTree() = default;
+	explicit SegmentTree(std::span<const T> a, Op op = {}) : tree_(2 * a.size()), n_(a.size()), op_(op) {
+		std::copy(a.begin(), a.end(), tree_.begin() + n_);
+		for (size_t i = n_; i-- > 1;) tree_[i] = op_(tree_[2 * i], tree_[2 * i + 1]);
+	}
+	size_t size() const { return n_; }
+	T query(size_t lo, size_t hi) const {
+		size_t l = lo + n_, r = hi + n_ + 1;
+		// no identity element is needed (min/max have none for a generic T): track what is folded in
+		T left{}, right{};
+		bool haveL = false, haveR = false;
+		for (; l < r; l >>= 1, r >>= 1) {
+			if (l & 1) { left = haveL ? op_(left, tree_[l]) : tree_[l]; haveL = true; l++; }
+			if (r & 1) { --r; right = haveR ? op_(tree_[r], right) : tree_[r]; haveR = true; }
+		}
+		if (!haveL) return right;
+		if (!haveR) return left;
+		return op_(left, right);
+	}
+	void set(size_t idx, T value) {
+		size_t i = idx + n_;
+		tree_[i] = value;
+		for (i >>= 1; i >= 1; i >>= 1) tree_[i] = op_(tree_[2 * i], tree_[2 * i + 1]);
+	}
+};
+
+template <typename T> using RangeMin = SparseTable<T, Min>;
+template <typename T> using RangeMax = SparseTable<T, Max>;
+template <typename T> using MinSegmentTree = SegmentTree<T, Min>;
+template <typename T> using MaxSegmentTree = SegmentTree<T, Max>;
+
+// Answers out[q] = index.query(ranges[q]) for the whole batch; big batches are split across the pool.
+template <typename Index>
+void queryMany(const Index& index, std::span<const Range> ranges, std::span<typename Index::value_type> out,
+	ThreadPool* pool = nullptr) {
+	auto work = [&](size_t b, size_t e) {
+		for (size_t q = b; q < e; q++) out[q] = index.query(ranges[q].lo, ranges[q].hi);
+	};
+	if (pool && ranges.size() >= 4096) pool->parallel_for(0, ranges.size(), 4096, work);
+	else work(0, ranges.size());
+}
+
+} // namespace rq
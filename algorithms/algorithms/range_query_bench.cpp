@@ -0,0 +1,105 @@
+// Benchmark: range sum / max queries per second, naive loop vs the rq:: indexes.
+// usage: range_query_bench [n=10000000] [queries=2000000]
+//
+// Two query shapes: short ranges (<= 64 elements, where the naive loop is at its best) and random
+// ranges anywhere in the array. The naive loop only runs a small sample of the random ranges
+// (each one is O(n)); its rate is extrapolated from that sample.
+// Every index is checked against the naive answers for the first queries of the batch.
+#include <iostream>
+#include <vector>
+#include <random>
+#include <climits>
+#include <cstdio>
+#include "range_query.h"
+#include "../../common/bench_util.h"
+
+int64_t naiveSum(const std::vector<int>& a, size_t i, size_t j) {
+	int64_t sum = 0;
+	for (size_t k = i; k <= j; k++) sum += a[k];
+	return sum;
+}
+
+int naiveMax(const std::vector<int>& a, size_t i, size_t j) {
+	int maxi = INT_MIN;
+	for (size_t k = i; k <= j; k++) if (a[k] > maxi) maxi = a[k];
+	return maxi;
+}
+
+template <typename Index>
+void timeBatch(const char* name, const Index& index, const std::vector<rq::Range>& ranges,
+	const std::vector<typename Index::value_type>& expect, double buildSec, ThreadPool* pool = nullptr) {
+	std::vector<typename Index::value_type> out(ranges.size());
+	bench::Stopwatch sw;
+	rq::queryMany(index, std::span<const rq::Range>(ranges), std::span<typename Index::value_type>(out), pool);
+	double sec = sw.seconds();
+	bool ok = std::equal(expect.begin(), expect.end(), out.begin());
+	std::printf("  %-28s %12.1f Mq/s   build %7.1f ms%s\n", name, ranges.size() / sec / 1e6, buildSec * 1e3,
+		ok ? "" : "  WRONG");
+}
+
+template <typename Index>
+Index build(const std::vector<int>& a, double& sec) {
+	bench::Stopwatch sw;
+	Index idx{ std::span<const int>(a) };
+	sec = sw.seconds();
+	return idx;
+}
+
+int main(int argc, char** argv) {
+	size_t n = static_cast<size_t>(bench::argOr(argc, argv, 1, 10000000));
+	size_t q = static_cast<size_t>(bench::argOr(argc, argv, 2, 2000000));
+	std::mt19937_64 rng(99);
+	std::vector<int> a(n);
+	for (auto& x : a) x = static_cast<int>(rng());
+
+	double tPrefix, tSparse, tFenwick, tSeg;
+	auto prefix = build<rq::PrefixSum<int>>(a, tPrefix);
+	auto sparse = build<rq::RangeMax<int>>(a, tSparse);
+	auto fenwick = build<rq::FenwickTree<int>>(a, tFenwick);
+	auto seg = build<rq::MaxSegmentTree<int>>(a, tSeg);
+
+	for (int shape = 0; shape < 2; shape++) {
+		std::vector<rq::Range> ranges(q);
+		for (auto& r : ranges) {
+			size_t i = rng() % n;
+			size_t j = shape == 0 ? std::min(n - 1, i + rng() % 64) : rng() % n;
+			r = { std::min(i, j), std::max(i, j) };
+		}
+
+		// naive answers for a sample: the ground truth for the checks, and the naive rate
+		size_t sample = shape == 0 ? q : std::min<size_t>(q, 2000);
+		std::vector<int64_t> sums(sample);
+		std::vector<int> maxes(sample);
+		bench::Stopwatch sw;
+		for (size_t k = 0; k < sample; k++) sums[k] = naiveSum(a, ranges[k].lo, ranges[k].hi);
+		double naiveSumRate = sample / sw.seconds() / 1e6;
+		sw.reset();
+		for (size_t k = 0; k < sample; k++) maxes[k] = naiveMax(a, ranges[k].lo, ranges[k].hi);
+		double naiveMaxRate = sample / sw.seconds() / 1e6;
+
+		std::printf("%s ranges, n=%zu, %zu queries\n", shape == 0 ? "short (<=64)" : "random", n, q);
+		std::printf("  %-28s %12.3f Mq/s\n", "naive sum loop", naiveSumRate);
+		std::printf("  %-28s %12.3f Mq/s\n", "naive max loop", naiveMaxRate);
+		timeBatch("prefix sum", prefix, ranges, sums, tPrefix);
+		timeBatch("fenwick sum", fenwick, ranges, sums, tFenwick);
+		timeBatch("sparse table max", sparse, ranges, maxes, tSparse);
+		timeBatch("segment tree max", seg, ranges, maxes, tSeg);
+		timeBatch("sparse table max, pool", sparse, ranges, maxes, 0, &ThreadPool::instance());
+	}
+
+	// slowly changing data: interleave point updates with queries
+	const size_t updates = q / 10;
+	bench::Stopwatch sw;
+	for (size_t k = 0; k < updates; k++) {
+		size_t idx = rng() % n;
+		int v = static_cast<int>(rng());
+		fenwick.set(idx, v);
+		seg.set(idx, v);
+		a[idx] = v;
+	}
+	double upd = sw.seconds();
+	size_t i = rng() % (n / 2), j = i + n / 2 - 1;
+	bool ok = fenwick.query(i, j) == naiveSum(a, i, j) && seg.query(i, j) == naiveMax(a, i, j);
+	std::printf("point updates (fenwick + segment tree): %.1f M/s%s\n", updates / upd / 1e6, ok ? "" : "  WRONG");
+	return 0;
+}
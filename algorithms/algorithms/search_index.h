@@ -0,0 +1,221 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "simd_scan.h"
+
+/*
+Static search indexes for sorted arrays much bigger than the cache, answering the same questions as
+std::lower_bound / std::upper_bound / std::equal_range (as indices into the sorted array).
+ - std::lower_bound on a sorted array: every probe is a cache miss once the array is out of L2,
+   and the next address is only known after the miss (plus a 50% mispredicted branch).
+ - EytzingerIndex : the same keys stored in BFS order (node k has children 2k and 2k+1).
+   The descent is branchless (k = 2k + (key < x)), and the 16 descendants four levels below node k
+   are one cache line, so it is prefetched while the current level is still being compared.
+ - STreeIndex     : a static B-tree, 16 keys (one cache line) per node and 17 children computed
+   from the node number, no pointers. One node compare is two AVX2 compares + popcount, and the
+   tree is log17(n) deep instead of log2(n), so a 1B-key search touches ~8 lines instead of ~30.
+ - Both keep the original index of every key next to it (uint32_t), so results are positions in the
+   sorted input like "std::lower_bound(a, a + n, x) - a". That doubles the memory for int keys.
+ - Build once, query many times; the indexes are read-only after construction.
+*/
+namespace search {
+
+namespace detail {
+
+// Cache-line aligned storage, so index arithmetic on node numbers maps onto whole lines.
+template <typename T>
+struct CacheAlignedAllocator {
+	using value_type = T;
+	static constexpr std::align_val_t Alignment{ 64 };
+	CacheAlignedAllocator() = default;
+	template <typename U> CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+	T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), Alignment)); }
+	void deallocate(T* p, size_t) { ::operator delete(p, Alignment); }
+	template <typename U> bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, CacheAlignedAllocator<T>>;
+
+inline void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(p);
+#elif SIMD_X86
+	_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#endif
+}
+
+inline void checkSize(size_t n) {
+	if (n >= std::numeric_limits<uint32_t>::max()) throw std::length_error("search index holds at most 2^32-2 keys");
+}
+
+#if SIMD_X86
+// Number of keys in a 16-int node that are < x (upper: <= x). Nodes are sorted, so this is
+// also the position of the first key >= x (> x).
+SIMD_TARGET("avx2")
+inline unsigned rankInNodeAVX2(const int* node, int x, bool upper) {
+	__m256i needle = _mm256_set1_epi32(x);
+	__m256i k0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(node));
+	__m256i k1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8));
+	__m256i gt0, gt1;
+	if (upper) { // keys > x
+		gt0 = _mm256_cmpgt_epi32(k0, needle);
+		gt1 = _mm256_cmpgt_epi32(k1, needle);
+	} else {     // x > keys
+		gt0 = _mm256_cmpgt_epi32(needle, k0);
+		gt1 = _mm256_cmpgt_epi32(needle, k1);
+	}
+	unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(gt0)))
+		| (static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(gt1))) << 8);
+	unsigned c = static_cast<unsigned>(std::popcount(mask));
+	return upper ? 16 - c : c;
+}
+#endif
+
+} // namespace detail
+
+template <typename T>
+class EytzingerIndex {
+private:
+	static constexpr size_t Lookahead = std::max<size_t>(1, 64 / sizeof(T)); // nodes 4 levels down (for int)
+
+	detail::AlignedVector<T> keys_;        // 1-based, keys_[0] unused
+	detail::AlignedVector<uint32_t> rank_; // rank_[k] = position of keys_[k] in the sorted input
+	size_t n_ = 0;
+
+	void build(std::span<const T> sorted) {
+		// in-order walk of the implicit tree hands out the sorted keys in order
+		size_t next = 0;
+		std::vector<size_t> stack;
+		size_t k = 1;
+		while (k <= n_ || !stack.empty()) {
+			while (k <= n_) { stack.push_back(k); k = 2 * k; }
+			k = stack.back();
+			stack.pop_back();
+			keys_[k] = sorted[next];
+			rank_[k] = static_cast<uint32_t>(next++);
+			k = 2 * k + 1;
+		}
+	}
+
+	// Eytzinger slot of the first key not less than x (upper: greater than x), 0 if there is none.
+	size_t descend(const T& x, bool upper) const {
+		const T* keys = keys_.data();
+		size_t k = 1;
+		if (upper) {
+			while (k <= n_) {
+				detail::prefetch(reinterpret_cast<const char*>(keys) + k * Lookahead * sizeof(T));
+				k = 2 * k + !(x < keys[k]);
+			}
+		} else {
+			while (k <= n_) {
+				detail::prefetch(reinterpret_cast<const char*>(keys) + k * Lookahead * sizeof(T));
+				k = 2 * k + (keys[k] < x);
+			}
+		}
+		// the path went right (1 bits) after the answer; drop those and the last left turn
+		return k >> (std::countr_one(k) + 1);
+	}
+
+public:
+	EytzingerIndex() = default;
+	explicit EytzingerIndex(std::span<const T> sorted) : keys_(sorted.size() + 1), rank_(sorted.size() + 1), n_(sorted.size()) {
+		detail::checkSize(n_);
+		build(sorted);
+	}
+
+	size_t size() const { return n_; }
+
+	size_t lowerBound(const T& x) const {
+		size_t k = descend(x, false);
+		return k ? rank_[k] : n_;
+	}
+	size_t upperBound(const T& x) const {
+		size_t k = descend(x, true);
+		return k ? rank_[k] : n_;
+	}
+	std::pair<size_t, size_t> equalRange(const T& x) const { return { lowerBound(x), upperBound(x) }; }
+	bool contains(const T& x) const {
+		size_t k = descend(x, false);
+		return k && !(x < keys_[k]);
+	}
+};
+
+template <typename T>
+class STreeIndex {
+public:
+	static constexpr size_t B = std::max<size_t>(2, 64 / sizeof(T)); // keys per node: one cache line
+
+private:
+	detail::AlignedVector<T> keys_;        // node k holds keys_[k*B, k*B + B)
+	detail::AlignedVector<uint32_t> rank_;
+	size_t n_ = 0, nodes_ = 0;
+	bool simd_ = false;
+
+	static size_t child(size_t k, size_t i) { return k * (B + 1) + i + 1; }
+
+	void build(size_t k, std::span<const T> sorted, size_t& next) {
+		if (k >= nodes_) return;
+		for (size_t i = 0; i < B; i++) {
+			build(child(k, i), sorted, next);
+			if (next < n_) {
+				keys_[k * B + i] = sorted[next];
+				rank_[k * B + i] = static_cast<uint32_t>(next++);
+			} else { // padding sorts after every real key
+				keys_[k * B + i] = std::numeric_limits<T>::max();
+				rank_[k * B + i] = static_cast<uint32_t>(n_);
+			}
+		}
+		build(child(k, B), sorted, next);
+	}
+
+	unsigned rankInNode(const T* node, const T& x, bool upper) const {
+#if SIMD_X86
+		if constexpr (std::is_same_v<T, int>) {
+			if (simd_) return detail::rankInNodeAVX2(node, x, upper);
+		}
+#endif
+		unsigned c = 0;
+		for (size_t i = 0; i < B; i++) c += upper ? !(x < node[i]) : (node[i] < x);
+		return c;
+	}
+
+	size_t search(const T& x, bool upper) const {
+		size_t k = 0, res = n_;
+		while (k < nodes_) {
+			const T* node = keys_.data() + k * B;
+			unsigned i = rankInNode(node, x, upper);
+			if (i < B) res = rank_[k * B + i]; // deeper levels only ever find earlier candidates
+			k = child(k, i);
+		}
+		return res;
+	}
+
+public:
+	STreeIndex() = default;
+	explicit STreeIndex(std::span<const T> sorted) : n_(sorted.size()) {
+		static_assert(std::numeric_limits<T>::is_specialized, "STreeIndex pads nodes with numeric_limits<T>::max()");
+		detail::checkSize(n_);
+		nodes_ = (n_ + B - 1) / B;
+		keys_.resize(nodes_ * B);
+		rank_.resize(nodes_ * B);
+		size_t next = 0;
+		build(0, sorted, next);
+		simd_ = simd::supportedLevel() >= simd::Level::AVX2;
+	}
+
+	size_t size() const { return n_; }
+	size_t lowerBound(const T& x) const { return search(x, false); }
+	size_t upperBound(const T& x) const { return search(x, true); }
+	std::pair<size_t, size_t> equalRange(const T& x) const { return { lowerBound(x), upperBound(x) }; }
+};
+
+} // namespace search
@@ -0,0 +1,62 @@
+// Benchmark: std::lower_bound vs EytzingerIndex vs STreeIndex, ns per search.
+// usage: search_index_bench [max n=100000000] [queries=1000000]
+//        (n = 1000000000 needs ~12 GB: the sorted array plus two indexes with their rank arrays)
+//
+// Sizes go 1K, 10K, ... up to max n. Keys are sorted random ints with duplicates; half of the
+// queries are present, half are misses. All lower_bound results are compared with std::lower_bound,
+// and equal_range is checked on a sample.
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include "search_index.h"
+#include "../../common/bench_util.h"
+
+template <typename F>
+double nsPerQuery(const std::vector<int>& queries, std::vector<size_t>& out, F&& fn) {
+	bench::Stopwatch sw;
+	for (size_t q = 0; q < queries.size(); q++) out[q] = fn(queries[q]);
+	return sw.nanos() / queries.size();
+}
+
+int main(int argc, char** argv) {
+	size_t maxN = static_cast<size_t>(bench::argOr(argc, argv, 1, 100000000));
+	size_t queryCount = static_cast<size_t>(bench::argOr(argc, argv, 2, 1000000));
+	std::mt19937 rng(11);
+
+	std::printf("%12s %14s %14s %14s %12s\n", "n", "std::lower", "eytzinger", "s-tree", "build ms");
+	for (size_t n = 1000; n <= maxN; n *= 10) {
+		std::vector<int> sorted(n);
+		for (auto& x : sorted) x = static_cast<int>(rng() % (4 * n)); // ~12% duplicates
+		std::sort(sorted.begin(), sorted.end());
+
+		std::vector<int> queries(queryCount);
+		for (size_t q = 0; q < queryCount; q++) {
+			queries[q] = (q & 1) ? sorted[rng() % n] : static_cast<int>(rng() % (4 * n + 2)) - 1;
+		}
+
+		bench::Stopwatch sw;
+		search::EytzingerIndex<int> eytz{ std::span<const int>(sorted) };
+		search::STreeIndex<int> stree{ std::span<const int>(sorted) };
+		double buildMs = sw.seconds() * 1e3;
+
+		std::vector<size_t> expect(queryCount), got(queryCount);
+		double tStd = nsPerQuery(queries, expect, [&](int x) {
+			return static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin());
+		});
+		double tEytz = nsPerQuery(queries, got, [&](int x) { return eytz.lowerBound(x); });
+		bool ok = got == expect;
+		double tTree = nsPerQuery(queries, got, [&](int x) { return stree.lowerBound(x); });
+		ok = ok && got == expect;
+
+		for (size_t q = 0; q < std::min<size_t>(queryCount, 10000); q++) {
+			auto range = std::equal_range(sorted.begin(), sorted.end(), queries[q]);
+			std::pair<size_t, size_t> want{ range.first - sorted.begin(), range.second - sorted.begin() };
+			ok = ok && eytz.equalRange(queries[q]) == want && stree.equalRange(queries[q]) == want;
+		}
+
+		std::printf("%12zu %11.1f ns %11.1f ns %11.1f ns %12.1f%s\n", n, tStd, tEytz, tTree, buildMs,
+			ok ? "" : "  MISMATCH");
+	}
+	return 0;
+}
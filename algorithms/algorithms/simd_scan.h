@@ -0,0 +1,315 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include "../../common/simd_support.h"
+
+/*
+Vectorized versions of the algorithms.cpp scans over int arrays: std::count, std::find,
+std::min_element / std::max_element and std::accumulate.
+ - Three implementations of every kernel: AVX2 (8 ints per op), SSE4.2 (4 ints), plain scalar.
+   The best one the CPU supports is picked once at startup (cpuid), so one binary runs everywhere.
+ - The same iterator-style calls as the STL: simd::count(nums, nums + 8, 1), simd::find(v.begin(), v.end(), 2), ...
+   Iterators must be contiguous (raw pointers, std::vector / std::array iterators).
+ - accumulate() sums into int64_t: std::accumulate(arr, arr + n, 0) sums into an int and
+   overflows after ~2 GB of small values.
+ - minmax() returns both values and the index of their first occurrence (what min_element and
+   max_element report). It is two passes: a vector min/max of the values, then a vector find of the
+   first position of each. Tracking indices inside the vector loop costs more than the second
+   pass, which usually stops early.
+ - On multi-GB arrays all of these are memory bound; SIMD mostly helps once the data is in cache
+   or the scalar loop had a branch per element (find, min/max with index).
+*/
+namespace simd {
+
+struct MinMax {
+	int min = INT_MAX, max = INT_MIN;
+	size_t minIndex = 0, maxIndex = 0; // first occurrence; 0 for an empty range
+};
+
+namespace detail {
+
+// ---------- scalar ----------
+
+inline size_t countScalar(const int* p, size_t n, int v) {
+	size_t c = 0;
+	for (size_t i = 0; i < n; i++) c += p[i] == v;
+	return c;
+}
+
+inline size_t findScalar(const int* p, size_t n, int v) {
+	for (size_t i = 0; i < n; i++) if (p[i] == v) return i;
+	return n;
+}
+
+inline void minMaxValuesScalar(const int* p, size_t n, int& mn, int& mx) {
+	for (size_t i = 0; i < n; i++) {
+		mn = std::min(mn, p[i]);
+		mx = std::max(mx, p[i]);
+	}
+}
+
+inline int64_t sumScalar(const int* p, size_t n) {
+	int64_t s = 0;
+	for (size_t i = 0; i < n; i++) s += p[i];
+	return s;
+}
+
+#if SIMD_X86
+
+// ---------- SSE4.2 (4 ints per register) ----------
+
+SIMD_TARGET("sse4.2")
+inline size_t countSSE(const int* p, size_t n, int v) {
+	const __m128i needle = _mm_set1_epi32(v);
+	size_t c = 0, i = 0;
+	while (i + 4 <= n) {
+		// per-lane counters are int32: flush them before they could overflow
+		size_t blockEnd = std::min(n & ~size_t(3), i + (size_t(1) << 30));
+		__m128i acc = _mm_setzero_si128();
+		for (; i < blockEnd; i += 4) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+			acc = _mm_sub_epi32(acc, _mm_cmpeq_epi32(x, needle)); // equal lanes are -1
+		}
+		alignas(16) uint32_t lanes[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+		c += size_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+	}
+	return c + countScalar(p + i, n - i, v);
+}
+
+SIMD_TARGET("sse4.2")
+inline size_t findSSE(const int* p, size_t n, int v) {
+	const __m128i needle = _mm_set1_epi32(v);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), needle);
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+		if (mask) return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+	}
+	return i + findScalar(p + i, n - i, v);
+}
+
+SIMD_TARGET("sse4.2")
+inline void minMaxValuesSSE(const int* p, size_t n, int& mn, int& mx) {
+	size_t i = 0;
+	if (n >= 4) {
+		__m128i vmin = _mm_set1_epi32(mn), vmax = _mm_set1_epi32(mx);
+		for (; i + 4 <= n; i += 4) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+			vmin = _mm_min_epi32(vmin, x);
+			vmax = _mm_max_epi32(vmax, x);
+		}
+		alignas(16) int lo[4], hi[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lo), vmin);
+		_mm_store_si128(reinterpret_cast<__m128i*>(hi), vmax);
+		mn = *std::min_element(lo, lo + 4);
+		mx = *std::max_element(hi, hi + 4);
+	}
+	minMaxValuesScalar(p + i, n - i, mn, mx);
+}
+
+SIMD_TARGET("sse4.2")
+inline int64_t sumSSE(const int* p, size_t n) {
+	__m128i acc = _mm_setzero_si128(); // two int64 lanes
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+		acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(x));
+		acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(x, 8)));
+	}
+	alignas(16) int64_t lanes[2];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+	return lanes[0] + lanes[1] + sumScalar(p + i, n - i);
+}
+
+// ---------- AVX2 (8 ints per register, loops unrolled x4 to keep two loads in flight) ----------
+
+SIMD_TARGET("avx2")
+inline size_t countAVX2(const int* p, size_t n, int v) {
+	const __m256i needle = _mm256_set1_epi32(v);
+	size_t c = 0, i = 0;
+	while (i + 32 <= n) {
+		size_t blockEnd = std::min(n & ~size_t(31), i + (size_t(1) << 30));
+		__m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+		for (; i < blockEnd; i += 32) {
+			const __m256i* q = reinterpret_cast<const __m256i*>(p + i);
+			a0 = _mm256_sub_epi32(a0, _mm256_cmpeq_epi32(_mm256_loadu_si256(q + 0), needle));
+			a1 = _mm256_sub_epi32(a1, _mm256_cmpeq_epi32(_mm256_loadu_si256(q + 1), needle));
+			a2 = _mm256_sub_epi32(a2, _mm256_cmpeq_epi32(_mm256_loadu_si256(q + 2), needle));
+			a3 = _mm256_sub_epi32(a3, _mm256_cmpeq_epi32(_mm256_loadu_si256(q + 3), needle));
+		}
+		alignas(32) uint32_t lanes[4][8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), a0);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), a1);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), a2);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[3]), a3);
+		for (auto& row : lanes) for (uint32_t x : row) c += x;
+	}
+	return c + countSSE(p + i, n - i, v);
+}
+
+SIMD_TARGET("avx2")
+inline size_t findAVX2(const int* p, size_t n, int v) {
+	const __m256i needle = _mm256_set1_epi32(v);
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32) {
+		const __m256i* q = reinterpret_cast<const __m256i*>(p + i);
+		__m256i e0 = _mm256_cmpeq_epi32(_mm256_loadu_si256(q + 0), needle);
+		__m256i e1 = _mm256_cmpeq_epi32(_mm256_loadu_si256(q + 1), needle);
+		__m256i e2 = _mm256_cmpeq_epi32(_mm256_loadu_si256(q + 2), needle);
+		__m256i e3 = _mm256_cmpeq_epi32(_mm256_loadu_si256(q + 3), needle);
+		__m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+		if (!_mm256_testz_si256(any, any)) {
+			// one branch per 32 ints; only now work out which of the four registers hit
+			const __m256i hits[4] = { e0, e1, e2, e3 };
+			for (size_t r = 0; r < 4; r++) {
+				int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hits[r]));
+				if (mask) return i + r * 8 + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+			}
+		}
+	}
+	return i + findSSE(p + i, n - i, v);
+}
+
+SIMD_TARGET("avx2")
+inline void minMaxValuesAVX2(const int* p, size_t n, int& mn, int& mx) {
+	size_t i = 0;
+	if (n >= 16) {
+		__m256i min0 = _mm256_set1_epi32(mn), min1 = min0, max0 = _mm256_set1_epi32(mx), max1 = max0;
+		for (; i + 16 <= n; i += 16) {
+			__m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+			__m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 8));
+			min0 = _mm256_min_epi32(min0, x0); max0 = _mm256_max_epi32(max0, x0);
+			min1 = _mm256_min_epi32(min1, x1); max1 = _mm256_max_epi32(max1, x1);
+		}
+		alignas(32) int lo[8], hi[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lo), _mm256_min_epi32(min0, min1));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(hi), _mm256_max_epi32(max0, max1));
+		mn = *std::min_element(lo, lo + 8);
+		mx = *std::max_element(hi, hi + 8);
+	}
+	minMaxValuesSSE(p + i, n - i, mn, mx);
+}
+
+SIMD_TARGET("avx2")
+inline int64_t sumAVX2(const int* p, size_t n) {
+	__m256i acc0 = _mm256_setzero_si256(), acc1 = acc0; // four int64 lanes each
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+		acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+		acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+	}
+	alignas(32) int64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumSSE(p + i, n - i);
+}
+
+#endif // SIMD_X86
+
+struct Kernels {
+	size_t (*count)(const int*, size_t, int);
+	size_t (*find)(const int*, size_t, int);
+	void (*minMaxValues)(const int*, size_t, int&, int&);
+	int64_t (*sum)(const int*, size_t);
+};
+
+inline const Kernels& kernelsFor(Level l) {
+	static const Kernels scalar{ countScalar, findScalar, minMaxValuesScalar, sumScalar };
+#if SIMD_X86
+	static const Kernels sse{ countSSE, findSSE, minMaxValuesSSE, sumSSE };
+	static const Kernels avx2{ countAVX2, findAVX2, minMaxValuesAVX2, sumAVX2 };
+	if (l == Level::AVX2) return avx2;
+	if (l == Level::SSE42) return sse;
+#endif
+	return scalar;
+}
+
+struct Dispatch {
+	Level supported = cpuLevel();
+	const Kernels* active = &kernelsFor(supported);
+	Level level = supported;
+};
+
+inline Dispatch& dispatch() {
+	static Dispatch d; // cpuid runs once, on first use
+	return d;
+}
+
+template <typename It>
+const int* rawPointer(It it) {
+	static_assert(std::is_same_v<std::remove_cv_t<typename std::iterator_traits<It>::value_type>, int>,
+		"simd:: kernels work on int arrays");
+	return std::to_address(it);
+}
+
+} // namespace detail
+
+inline Level supportedLevel() { return detail::dispatch().supported; }
+inline Level activeLevel() { return detail::dispatch().level; }
+
+// Forces a lower level (benchmarks, or ruling out a kernel bug); levels above the CPU's are clamped.
+// Not thread-safe: call it before other threads use the kernels.
+inline Level setLevel(Level l) {
+	detail::Dispatch& d = detail::dispatch();
+	d.level = std::min(l, d.supported);
+	d.active = &detail::kernelsFor(d.level);
+	return d.level;
+}
+
+template <typename It>
+size_t count(It first, It last, int value) {
+	return detail::dispatch().active->count(detail::rawPointer(first), static_cast<size_t>(last - first), value);
+}
+
+template <typename It>
+It find(It first, It last, int value) {
+	return first + detail::dispatch().active->find(detail::rawPointer(first), static_cast<size_t>(last - first), value);
+}
+
+template <typename It>
+int64_t accumulate(It first, It last, int64_t init = 0) {
+	return init + detail::dispatch().active->sum(detail::rawPointer(first), static_cast<size_t>(last - first));
+}
+
+template <typename It>
+MinMax minmax(It first, It last) {
+	MinMax r;
+	size_t n = static_cast<size_t>(last - first);
+	if (n == 0) return r;
+	const detail::Kernels& k = *detail::dispatch().active;
+	const int* p = detail::rawPointer(first);
+	k.minMaxValues(p, n, r.min, r.max);
+	r.minIndex = k.find(p, n, r.min);
+	r.maxIndex = k.find(p, n, r.max);
+	return r;
+}
+
+// Same result as std::min_element / std::max_element (first occurrence, last if empty).
+template <typename It>
+It min_element(It first, It last) {
+	size_t n = static_cast<size_t>(last - first);
+	if (n == 0) return last;
+	const detail::Kernels& k = *detail::dispatch().active;
+	int mn = INT_MAX, mx = INT_MIN;
+	k.minMaxValues(detail::rawPointer(first), n, mn, mx);
+	return first + k.find(detail::rawPointer(first), n, mn);
+}
+
+template <typename It>
+It max_element(It first, It last) {
+	size_t n = static_cast<size_t>(last - first);
+	if (n == 0) return last;
+	const detail::Kernels& k = *detail::dispatch().active;
+	int mn = INT_MAX, mx = INT_MIN;
+	k.minMaxValues(detail::rawPointer(first), n, mn, mx);
+	return first + k.find(detail::rawPointer(first), n, mx);
+}
+
+} // namespace simd
@@ -0,0 +1,84 @@
+// Benchmark: simd:: scan kernels against the STL, in GB/s of int data read.
+// usage: simd_scan_bench [big n=67108864 (256 MB)] [reps=5]
+//
+// Two sizes: 16K ints (64 KB, fits in L2, shows the compute side) and "big n" (memory bound).
+// Each kernel runs at every level the CPU supports (simd::setLevel), and every result is
+// compared with the STL answer.
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <random>
+#include <functional>
+#include <cstdio>
+#include "simd_scan.h"
+#include "../../common/bench_util.h"
+
+double gbPerSec(size_t n, int reps, const std::function<void()>& fn) {
+	fn(); // warm up: page faults, caches
+	double best = 1e30;
+	for (int r = 0; r < reps; r++) {
+		bench::Stopwatch sw;
+		fn();
+		best = std::min(best, sw.seconds());
+	}
+	return n * sizeof(int) / best / 1e9;
+}
+
+void runSize(size_t n, int reps) {
+	// small values, a few hits for count, the find target near the end, extremes somewhere in the middle
+	std::mt19937 rng(5);
+	std::vector<int> v(n);
+	for (auto& x : v) x = static_cast<int>(rng() % 1000);
+	v[n - n / 16] = -7;
+	v[n / 3] = 5000;
+	v[n / 2] = -5000;
+	const int needle = 42, target = -7;
+	// enough iterations per timed call that the 16K case is not just timer noise
+	int inner = static_cast<int>(std::max<size_t>(1, (size_t(64) << 20) / n));
+
+	size_t stdCount = static_cast<size_t>(std::count(v.begin(), v.end(), needle));
+	auto stdFind = std::find(v.begin(), v.end(), target);
+	auto stdMin = std::min_element(v.begin(), v.end()), stdMax = std::max_element(v.begin(), v.end());
+	int64_t stdSum = std::accumulate(v.begin(), v.end(), int64_t(0));
+
+	std::printf("n = %zu ints (%.1f MB)\n", n, n * sizeof(int) / 1e6);
+	std::printf("  %-8s %10s %10s %10s %10s\n", "", "count", "find", "min+max", "sum");
+	auto line = [&](const char* name, auto count, auto find, auto minmax, auto sum) {
+		double c = gbPerSec(n * inner, reps, [&] { for (int k = 0; k < inner; k++) bench::doNotOptimize(count()); });
+		double f = gbPerSec((stdFind - v.begin()) * size_t(inner), reps, [&] { for (int k = 0; k < inner; k++) bench::doNotOptimize(find()); });
+		double m = gbPerSec(n * inner, reps, [&] { for (int k = 0; k < inner; k++) bench::doNotOptimize(minmax()); });
+		double s = gbPerSec(n * inner, reps, [&] { for (int k = 0; k < inner; k++) bench::doNotOptimize(sum()); });
+		std::printf("  %-8s %7.2f GB/s %6.2f GB/s %6.2f GB/s %6.2f GB/s\n", name, c, f, m, s);
+	};
+
+	line("STL",
+		[&] { return std::count(v.begin(), v.end(), needle); },
+		[&] { return std::find(v.begin(), v.end(), target) - v.begin(); },
+		[&] { return (std::min_element(v.begin(), v.end()) - v.begin()) + (std::max_element(v.begin(), v.end()) - v.begin()); },
+		[&] { return std::accumulate(v.begin(), v.end(), int64_t(0)); });
+
+	for (simd::Level l : { simd::Level::Scalar, simd::Level::SSE42, simd::Level::AVX2 }) {
+		if (l > simd::supportedLevel()) continue;
+		simd::setLevel(l);
+		simd::MinMax mm = simd::minmax(v.begin(), v.end());
+		bool ok = simd::count(v.begin(), v.end(), needle) == stdCount && simd::find(v.begin(), v.end(), target) == stdFind
+			&& mm.minIndex == size_t(stdMin - v.begin()) && mm.maxIndex == size_t(stdMax - v.begin())
+			&& simd::accumulate(v.begin(), v.end()) == stdSum;
+		line(simd::toString(l),
+			[&] { return simd::count(v.begin(), v.end(), needle); },
+			[&] { return simd::find(v.begin(), v.end(), target) - v.begin(); },
+			[&] { simd::MinMax r = simd::minmax(v.begin(), v.end()); return r.minIndex + r.maxIndex; },
+			[&] { return simd::accumulate(v.begin(), v.end()); });
+		if (!ok) std::printf("  %s results differ from the STL!\n", simd::toString(l));
+	}
+	simd::setLevel(simd::supportedLevel());
+}
+
+int main(int argc, char** argv) {
+	size_t bigN = static_cast<size_t>(bench::argOr(argc, argv, 1, 64 << 20));
+	int reps = static_cast<int>(bench::argOr(argc, argv, 2, 5));
+	std::printf("CPU supports: %s\n", simd::toString(simd::supportedLevel()));
+	runSize(16 * 1024, reps);
+	runSize(bigN, reps);
+	return 0;
+}
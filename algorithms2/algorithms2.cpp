@@ -6,6 +6,8 @@
 int main() {
 
 	// set_union()
+	// (inputs with millions of sorted ids: set_ops.h - SIMD/galloping/parallel union, intersection, difference)
+	// (merging k sorted runs in one pass, e.g. from files: kway_merge.h - loser tree k-way merge)
 	int first[5] = {1,3,5,8,9};
 	int second[5] = { 1,2,5,6,10 };
 	std::vector<int>result(10);
@@ -23,6 +25,7 @@ int main() {
 	printf("\n");
 
 	// unique()
+	// (hundreds of millions of ints: compaction.h - compact::unique / removeIf, branchless SIMD and parallel)
 	/*std::vector<int>arr = { 1,1,2,3,3 };
 	auto it = std::unique(arr.begin(), arr.end());
 	arr.erase(it, arr.end());
@@ -32,6 +35,7 @@ int main() {
 	printf("\n");*/
 
 	// make_heap()
+	// (priority queues with decrease-key and streaming top-k: dary_heap.h - 4/8-ary heaps, dheap::topK)
 	std::vector<int>heap_data = {4, 1, 7, 9, 3};
 	std::make_heap(heap_data.begin(), heap_data.end());
 	printf("heap: ");
@@ -41,6 +45,8 @@ int main() {
 
 
 	// task: find and print only duplicates
+	// (for millions of ints use flat_hash_map.h: hashing::countDuplicates, flat open addressing instead of one node per element)
+	// (multi-threaded: parallel_histogram.h - hashing::findDuplicates / histogram, hash-partitioned, no locks)
 	/*std::unordered_map<int, int>umap;
 	std::vector<int>vecr = { 1,1,2,3,3,4,4 };
 	for (auto& it : vecr) {
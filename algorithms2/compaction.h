@@ -0,0 +1,250 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "../common/simd_support.h"
+#include "../common/thread_pool.h"
+
+/*
+Stream compaction: keep some elements of an array, packed to the front, in order
+(std::remove_if, std::copy_if, std::unique on sorted data).
+ - The STL loops branch on every element. With a 50/50 keep decision that is a mispredict every other
+   element (~15 cycles each); dedup of sorted data with many short runs is the same.
+ - Scalar here is branchless: always store, advance the output by 0 or 1.
+ - SIMD (32-bit elements): the keep decisions of 8 (AVX2) / 4 (SSE) elements form a bitmask, a
+   table indexed by the mask holds the permutation that moves the kept lanes to the front, then one
+   unaligned store of the whole vector and out += popcount(mask). The lanes past the kept ones are
+   garbage that the next store overwrites.
+ - The predicate is evaluated into the mask element by element (no branch, and simple predicates
+   get vectorized by the compiler); the permute + store is what replaces the branchy copy.
+   unique() builds its mask with one vector compare against the vector shifted by one lane.
+ - Every kernel works in place (out == in): the output never gets ahead of the input, and a store
+   only overwrites elements that are already loaded.
+ - Parallel (pool != nullptr): chunks are compacted in place independently, then moved together
+   with memmove in order (each one only moves left). unique() reads the element before each chunk
+   first, so a run that crosses a chunk boundary is still cut correctly.
+*/
+namespace compact {
+
+constexpr size_t MinParallelChunk = 1 << 18; // elements; below this a chunk is not worth a task
+
+namespace detail {
+
+template <typename T>
+constexpr bool Simd32 = sizeof(T) == 4 && std::is_trivially_copyable_v<T>;
+
+// For each 8-bit mask: lane indices of the set bits first (in order), then anything.
+constexpr std::array<std::array<uint32_t, 8>, 256> makePermute8() {
+	std::array<std::array<uint32_t, 8>, 256> table{};
+	for (uint32_t mask = 0; mask < 256; mask++) {
+		uint32_t k = 0;
+		for (uint32_t lane = 0; lane < 8; lane++) {
+			if (mask & (1u << lane)) table[mask][k++] = lane;
+		}
+		for (; k < 8; k++) table[mask][k] = 0;
+	}
+	return table;
+}
+
+// For each 4-bit mask: byte shuffle (pshufb) moving the kept 4-byte lanes to the front.
+constexpr std::array<std::array<uint8_t, 16>, 16> makeShuffle4() {
+	std::array<std::array<uint8_t, 16>, 16> table{};
+	for (uint32_t mask = 0; mask < 16; mask++) {
+		uint32_t k = 0;
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			if (!(mask & (1u << lane))) continue;
+			for (uint32_t b = 0; b < 4; b++) table[mask][k * 4 + b] = static_cast<uint8_t>(lane * 4 + b);
+			k++;
+		}
+		for (; k < 4; k++) {
+			for (uint32_t b = 0; b < 4; b++) table[mask][k * 4 + b] = 0x80; // zero
+		}
+	}
+	return table;
+}
+
+alignas(32) inline constexpr auto Permute8 = makePermute8();
+alignas(16) inline constexpr auto Shuffle4 = makeShuffle4();
+
+template <typename T, typename Keep>
+size_t compactScalar(const T* in, size_t n, T* out, Keep&& keep) {
+	size_t w = 0;
+	for (size_t i = 0; i < n; i++) {
+		T x = in[i];
+		bool k = keep(x);
+		out[w] = x;
+		w += k;
+	}
+	return w;
+}
+
+// Keeps in[i] when it differs from the element before it (*before for i == 0, if there is one).
+template <typename T>
+size_t uniqueScalar(const T* in, size_t n, T* out, const T* before) {
+	if (n == 0) return 0;
+	size_t w = 0;
+	T prev = in[0];
+	if (!before || !(*before == prev)) out[w++] = prev;
+	for (size_t i = 1; i < n; i++) {
+		T x = in[i];
+		out[w] = x;
+		w += !(x == prev);
+		prev = x;
+	}
+	return w;
+}
+
+#if SIMD_X86
+template <typename T, typename Keep>
+SIMD_TARGET("avx2")
+size_t compactAVX2(const T* in, size_t n, T* out, Keep&& keep) {
+	size_t i = 0, w = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+		uint32_t mask = 0;
+		for (uint32_t lane = 0; lane < 8; lane++) mask |= static_cast<uint32_t>(static_cast<bool>(keep(in[i + lane]))) << lane;
+		__m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i*>(Permute8[mask].data()));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + w), _mm256_permutevar8x32_epi32(v, perm));
+		w += static_cast<size_t>(std::popcount(mask));
+	}
+	return w + compactScalar(in + i, n - i, out + w, keep);
+}
+
+template <typename T, typename Keep>
+SIMD_TARGET("sse4.2")
+size_t compactSSE(const T* in, size_t n, T* out, Keep&& keep) {
+	size_t i = 0, w = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		uint32_t mask = 0;
+		for (uint32_t lane = 0; lane < 4; lane++) mask |= static_cast<uint32_t>(static_cast<bool>(keep(in[i + lane]))) << lane;
+		__m128i shuf = _mm_load_si128(reinterpret_cast<const __m128i*>(Shuffle4[mask].data()));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + w), _mm_shuffle_epi8(v, shuf));
+		w += static_cast<size_t>(std::popcount(mask));
+	}
+	return w + compactScalar(in + i, n - i, out + w, keep);
+}
+
+// uniqueScalar for 32-bit integers.
+template <typename T>
+SIMD_TARGET("avx2")
+size_t uniqueAVX2(const T* in, size_t n, T* out, const T* before) {
+	if (n == 0) return 0;
+	size_t w = 0;
+	T last = in[0];
+	if (!before || *before != last) out[w++] = last;
+	size_t i = 1;
+	const __m256i shiftOne = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+	for (; i + 8 <= n; i += 8) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+		// lane j holds in[i + j - 1]; lane 0 comes from the last element of the previous block, kept in a
+		// register because in-place stores may already have overwritten it
+		__m256i prev = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(v, shiftOne), _mm256_set1_epi32(static_cast<int>(last)), 1);
+		uint32_t same = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, prev))));
+		uint32_t mask = ~same & 0xFF;
+		last = static_cast<T>(_mm256_extract_epi32(v, 7));
+		__m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i*>(Permute8[mask].data()));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + w), _mm256_permutevar8x32_epi32(v, perm));
+		w += static_cast<size_t>(std::popcount(mask));
+	}
+	for (; i < n; i++) {
+		T x = in[i];
+		out[w] = x;
+		w += x != last;
+		last = x;
+	}
+	return w;
+}
+#endif
+
+template <typename T, typename Keep>
+size_t compactRange(const T* in, size_t n, T* out, Keep&& keep, simd::Level level) {
+#if SIMD_X86
+	if constexpr (Simd32<T>) {
+		if (level >= simd::Level::AVX2) return compactAVX2(in, n, out, keep);
+		if (level >= simd::Level::SSE42) return compactSSE(in, n, out, keep);
+	}
+#endif
+	(void)level;
+	return compactScalar(in, n, out, keep);
+}
+
+template <typename T>
+size_t uniqueRange(const T* in, size_t n, T* out, const T* before, simd::Level level) {
+#if SIMD_X86
+	if constexpr (Simd32<T> && std::is_integral_v<T>) {
+		if (level >= simd::Level::AVX2) return uniqueAVX2(in, n, out, before);
+	}
+#endif
+	(void)level;
+	return uniqueScalar(in, n, out, before);
+}
+
+struct Chunks {
+	size_t count = 1, len = 0;
+	Chunks(size_t n, ThreadPool* pool) {
+		if (pool) count = std::max<size_t>(1, std::min<size_t>(pool->size() + 1, n / MinParallelChunk));
+		len = (n + count - 1) / count;
+	}
+};
+
+// Runs kernel(chunk, begin, count) -> kept on every chunk in place, then packs the chunks together.
+template <typename T, typename Kernel>
+size_t chunked(std::span<T> values, const Chunks& plan, ThreadPool* pool, Kernel&& kernel) {
+	size_t n = values.size(), len = plan.len;
+	if (plan.count <= 1) return kernel(size_t{ 0 }, size_t{ 0 }, n);
+	std::vector<size_t> kept(plan.count);
+	pool->parallel_for(0, plan.count, 1, [&](size_t lo, size_t hi) {
+		for (size_t c = lo; c < hi; c++) kept[c] = kernel(c, c * len, std::min(n, c * len + len) - c * len);
+	});
+	// each chunk only moves left, so in order this never overwrites data that is still to be moved
+	size_t total = kept[0];
+	for (size_t c = 1; c < plan.count; c++) {
+		if (kept[c]) std::memmove(values.data() + total, values.data() + c * len, kept[c] * sizeof(T));
+		total += kept[c];
+	}
+	return total;
+}
+
+} // namespace detail
+
+// Copies the elements with keep(x) to out, in order; returns how many. out needs room for in.size()
+// elements (vector stores write past the kept ones); out may be in.data().
+template <typename T, typename Keep>
+size_t copyIf(std::span<const T> in, T* out, Keep keep, simd::Level level = simd::cpuLevel()) {
+	return detail::compactRange(in.data(), in.size(), out, keep, std::min(level, simd::cpuLevel()));
+}
+
+// Like std::remove_if: the elements without remove(x) are packed to the front, in order; returns
+// their count (the new logical size). Everything after that is unspecified.
+template <typename T, typename Remove>
+size_t removeIf(std::span<T> values, Remove remove, ThreadPool* pool = nullptr, simd::Level level = simd::cpuLevel()) {
+	level = std::min(level, simd::cpuLevel());
+	auto keep = [&remove](const T& x) { return !remove(x); };
+	return detail::chunked(values, detail::Chunks(values.size(), pool), pool, [&](size_t, size_t begin, size_t count) {
+		T* p = values.data() + begin;
+		return detail::compactRange<T>(p, count, p, keep, level);
+	});
+}
+
+// Like std::unique on a sorted (or grouped) range: keeps the first of every run of equal elements,
+// packed to the front; returns their count.
+template <typename T>
+size_t unique(std::span<T> values, ThreadPool* pool = nullptr, simd::Level level = simd::cpuLevel()) {
+	level = std::min(level, simd::cpuLevel());
+	detail::Chunks plan(values.size(), pool);
+	// the element before every chunk, read before any chunk is rewritten
+	std::vector<T> before(plan.count);
+	for (size_t c = 1; c < plan.count; c++) before[c] = values[c * plan.len - 1];
+	return detail::chunked(values, plan, pool, [&](size_t chunk, size_t begin, size_t count) {
+		T* p = values.data() + begin;
+		return detail::uniqueRange<T>(p, count, p, chunk ? &before[chunk] : nullptr, level);
+	});
+}
+
+} // namespace compact
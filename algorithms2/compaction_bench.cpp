@@ -0,0 +1,75 @@
+// Benchmark: compact::unique / removeIf against std::unique / std::remove_if (+ erase).
+// usage: compaction_bench [n=100000000] [reps=3]
+//
+// unique   : n sorted ints drawn from [0, n/2), so runs are short (mostly 1-3) and the STL branch is
+//            unpredictable; and n sorted ints from [0, n/64) (long runs, the branch is easy)
+// removeIf : remove the odd values of n random ints (50/50, unpredictable) and of values < INT_MAX/100 (1%)
+// Each compact:: variant runs at scalar / sse4.2 / avx2 (up to what the CPU has) and with the
+// thread pool; every result is compared with the STL result. Times in ms, best of reps.
+// unique has no SSE kernel (its sse4.2 column is the scalar code).
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <limits>
+#include "compaction.h"
+#include "../common/bench_util.h"
+
+template <typename Prepare, typename Run>
+double best(int reps, Prepare&& prepare, Run&& run) {
+	double t = 1e30;
+	for (int r = 0; r < reps; r++) {
+		prepare();
+		bench::Stopwatch sw;
+		run();
+		t = std::min(t, sw.seconds());
+	}
+	return t;
+}
+
+int main(int argc, char** argv) {
+	size_t n = static_cast<size_t>(bench::argOr(argc, argv, 1, 100000000));
+	int reps = static_cast<int>(bench::argOr(argc, argv, 2, 3));
+	ThreadPool& pool = ThreadPool::instance();
+	std::mt19937 rng(49);
+	std::printf("n = %zu, threads in pool: %u, times in ms\n", n, pool.size());
+	std::printf("%-22s %8s %8s %8s %8s %9s\n", "", "STL", "scalar", "sse4.2", "avx2", "parallel");
+
+	std::vector<int> input(n), work;
+	auto row = [&](const char* name, auto stl, auto ours) {
+		std::vector<int> expect;
+		double tStl = best(reps, [&] { work = input; }, [&] { stl(work); });
+		expect = work;
+		std::printf("%-22s %8.1f", name, tStl * 1e3);
+		bool ok = true;
+		auto variant = [&](simd::Level level, ThreadPool* p) {
+			if (level > simd::cpuLevel()) { std::printf(" %8s", "-"); return; }
+			double t = best(reps, [&] { work = input; }, [&] { work.resize(ours(std::span<int>(work), p, level)); });
+			ok = ok && work == expect;
+			std::printf(" %8.1f", t * 1e3);
+		};
+		variant(simd::Level::Scalar, nullptr);
+		variant(simd::Level::SSE42, nullptr);
+		variant(simd::Level::AVX2, nullptr);
+		variant(simd::cpuLevel(), &pool);
+		std::printf("%s\n", ok ? "" : "  MISMATCH");
+	};
+
+	auto stlUnique = [](std::vector<int>& v) { v.erase(std::unique(v.begin(), v.end()), v.end()); };
+	auto ourUnique = [](std::span<int> v, ThreadPool* p, simd::Level l) { return compact::unique(v, p, l); };
+	for (auto [name, universe] : { std::pair{ "unique, short runs", n / 2 }, std::pair{ "unique, long runs", n / 64 } }) {
+		for (auto& x : input) x = static_cast<int>(rng() % std::max<size_t>(1, universe));
+		std::sort(input.begin(), input.end());
+		row(name, stlUnique, ourUnique);
+	}
+
+	for (auto& x : input) x = static_cast<int>(rng() >> 1);
+	row("remove_if odd (50%)",
+		[](std::vector<int>& v) { v.erase(std::remove_if(v.begin(), v.end(), [](int x) { return x & 1; }), v.end()); },
+		[](std::span<int> v, ThreadPool* p, simd::Level l) { return compact::removeIf(v, [](int x) { return x & 1; }, p, l); });
+	int cut = std::numeric_limits<int>::max() / 100; // values are in [0, 2^31): 1% are below
+	row("remove_if small (1%)",
+		[cut](std::vector<int>& v) { v.erase(std::remove_if(v.begin(), v.end(), [cut](int x) { return x < cut; }), v.end()); },
+		[cut](std::span<int> v, ThreadPool* p, simd::Level l) { return compact::removeIf(v, [cut](int x) { return x < cut; }, p, l); });
+	return 0;
+}
@@ -0,0 +1,338 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../common/simd_support.h"
+
+/*
+d-ary heaps and streaming top-K.
+ - std::make_heap / std::priority_queue are binary heaps: a pop walks log2(n) levels, and below the
+   top few levels every level is a cache miss.
+ - DaryHeap<T, D>: every node has D children (4 or 8). The tree is log_D(n) deep (half / a third of
+   the levels), and the D children of a node are next to each other, so picking the best child is
+   D compares within one or two cache lines instead of another miss. Push does fewer compares still.
+   Comp works like std::priority_queue: std::less<> puts the largest element on top.
+ - IndexedDaryHeap<T, D>: push() returns a Handle that stays valid while the element is in the heap;
+   update(handle, value) moves the element up or down (decrease-key for Dijkstra / A* / timers),
+   erase(handle) removes it from the middle. Handles are recycled after pop / erase.
+ - TopK<T>: keeps the k best elements of a stream in a bounded heap whose top is the worst kept
+   element, the threshold. After the first few thousand elements almost everything is below the
+   threshold, so for int the stream is compared against it 8 (AVX2) or 4 (SSE) at a time and a
+   whole block is skipped when no lane beats it; only survivors go through the heap.
+   topK(values, k) wraps it and returns the k best, best first.
+*/
+namespace dheap {
+
+template <typename T, size_t D = 4, typename Comp = std::less<>>
+class DaryHeap {
+	static_assert(D >= 2, "a heap node needs at least two children");
+
+private:
+	std::vector<T> data_;
+	Comp comp_;
+
+	// comp_(a, b): a goes below b. Returns the child of i that should be on top, or size() if i is a leaf.
+	size_t bestChild(size_t i) const {
+		size_t first = D * i + 1;
+		size_t n = data_.size();
+		if (first >= n) return n;
+		size_t last = std::min(first + D, n), best = first;
+		for (size_t c = first + 1; c < last; c++) {
+			if (comp_(data_[best], data_[c])) best = c;
+		}
+		return best;
+	}
+
+	void siftUp(size_t i) {
+		T x = std::move(data_[i]);
+		while (i > 0) {
+			size_t parent = (i - 1) / D;
+			if (!comp_(data_[parent], x)) break;
+			data_[i] = std::move(data_[parent]);
+			i = parent;
+		}
+		data_[i] = std::move(x);
+	}
+
+	void siftDown(size_t i) {
+		T x = std::move(data_[i]);
+		for (size_t c; (c = bestChild(i)) < data_.size() && comp_(x, data_[c]); i = c) {
+			data_[i] = std::move(data_[c]);
+		}
+		data_[i] = std::move(x);
+	}
+
+public:
+	explicit DaryHeap(Comp comp = {}) : comp_(comp) {}
+
+	// Builds the heap from arbitrary values in O(n), like std::make_heap.
+	explicit DaryHeap(std::vector<T> values, Comp comp = {}) : data_(std::move(values)), comp_(comp) {
+		if (data_.size() > 1) {
+			for (size_t i = (data_.size() - 2) / D + 1; i-- > 0;) siftDown(i);
+		}
+	}
+
+	size_t size() const { return data_.size(); }
+	bool empty() const { return data_.empty(); }
+	void reserve(size_t n) { data_.reserve(n); }
+	void clear() { data_.clear(); }
+	const T& top() const { return data_.front(); }
+
+	void push(T x) {
+		data_.push_back(std::move(x));
+		siftUp(data_.size() - 1);
+	}
+
+	void pop() {
+		if (data_.size() > 1) {
+			data_.front() = std::move(data_.back());
+			data_.pop_back();
+			siftDown(0);
+		} else {
+			data_.clear();
+		}
+	}
+
+	// pop() + push(x) with one sift instead of two.
+	void replaceTop(T x) {
+		data_.front() = std::move(x);
+		siftDown(0);
+	}
+
+	// The elements in heap order; takes them out of the heap.
+	std::vector<T> release() { return std::move(data_); }
+};
+
+template <typename T, size_t D = 4, typename Comp = std::less<>>
+class IndexedDaryHeap {
+	static_assert(D >= 2, "a heap node needs at least two children");
+
+public:
+	using Handle = uint32_t;
+
+private:
+	static constexpr uint32_t NotInHeap = ~uint32_t{ 0 };
+
+	struct Node {
+		T value;
+		Handle handle;
+	};
+	std::vector<Node> data_;
+	std::vector<uint32_t> pos_;    // pos_[handle] = index in data_, or NotInHeap
+	std::vector<Handle> freeList_;
+	Comp comp_;
+
+	void place(size_t i, Node&& n) {
+		pos_[n.handle] = static_cast<uint32_t>(i);
+		data_[i] = std::move(n);
+	}
+
+	void siftUp(size_t i) {
+		Node x = std::move(data_[i]);
+		while (i > 0) {
+			size_t parent = (i - 1) / D;
+			if (!comp_(data_[parent].value, x.value)) break;
+			place(i, std::move(data_[parent]));
+			i = parent;
+		}
+		place(i, std::move(x));
+	}
+
+	void siftDown(size_t i) {
+		Node x = std::move(data_[i]);
+		size_t n = data_.size();
+		while (true) {
+			size_t first = D * i + 1;
+			if (first >= n) break;
+			size_t last = std::min(first + D, n), best = first;
+			for (size_t c = first + 1; c < last; c++) {
+				if (comp_(data_[best].value, data_[c].value)) best = c;
+			}
+			if (!comp_(x.value, data_[best].value)) break;
+			place(i, std::move(data_[best]));
+			i = best;
+		}
+		place(i, std::move(x));
+	}
+
+	void removeAt(size_t i) {
+		pos_[data_[i].handle] = NotInHeap;
+		freeList_.push_back(data_[i].handle);
+		if (i + 1 == data_.size()) {
+			data_.pop_back();
+			return;
+		}
+		data_[i] = std::move(data_.back());
+		data_.pop_back();
+		Handle moved = data_[i].handle;
+		pos_[moved] = static_cast<uint32_t>(i);
+		siftUp(i);
+		if (pos_[moved] == i) siftDown(i); // did not move up: it may belong further down
+	}
+
+	size_t indexOf(Handle h) const {
+		if (h >= pos_.size() || pos_[h] == NotInHeap) throw std::out_of_range("IndexedDaryHeap: handle not in heap");
+		return pos_[h];
+	}
+
+public:
+	explicit IndexedDaryHeap(Comp comp = {}) : comp_(comp) {}
+
+	size_t size() const { return data_.size(); }
+	bool empty() const { return data_.empty(); }
+	void reserve(size_t n) {
+		data_.reserve(n);
+		pos_.reserve(n);
+	}
+
+	const T& top() const { return data_.front().value; }
+	Handle topHandle() const { return data_.front().handle; }
+	bool contains(Handle h) const { return h < pos_.size() && pos_[h] != NotInHeap; }
+	const T& value(Handle h) const { return data_[indexOf(h)].value; }
+
+	Handle push(T x) {
+		Handle h;
+		if (!freeList_.empty()) {
+			h = freeList_.back();
+			freeList_.pop_back();
+		} else {
+			if (pos_.size() >= NotInHeap) throw std::length_error("IndexedDaryHeap: out of handles");
+			h = static_cast<Handle>(pos_.size());
+			pos_.push_back(NotInHeap);
+		}
+		data_.push_back({ std::move(x), h });
+		pos_[h] = static_cast<uint32_t>(data_.size() - 1);
+		siftUp(data_.size() - 1);
+		return h;
+	}
+
+	void pop() { removeAt(0); }
+	void erase(Handle h) { removeAt(indexOf(h)); }
+
+	// Changes the element's value and restores the heap: moves up when it got better (decrease-key in
+	// a min-heap), down when it got worse.
+	void update(Handle h, T x) {
+		size_t i = indexOf(h);
+		bool better = comp_(data_[i].value, x);
+		data_[i].value = std::move(x);
+		if (better) siftUp(i);
+		else siftDown(i);
+	}
+};
+
+namespace detail {
+
+#if SIMD_X86
+// Start of the first 8-value block in [i, n) with a value > threshold, or of the tail (< 8 values) if none.
+SIMD_TARGET("avx2")
+inline size_t skipNotAboveAVX2(const int* v, size_t i, size_t n, int threshold) {
+	__m256i t = _mm256_set1_epi32(threshold);
+	for (; i + 8 <= n; i += 8) {
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+		if (_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, t)))) return i;
+	}
+	return i;
+}
+
+// Same with 4-value blocks.
+SIMD_TARGET("sse4.2")
+inline size_t skipNotAboveSSE(const int* v, size_t i, size_t n, int threshold) {
+	__m128i t = _mm_set1_epi32(threshold);
+	for (; i + 4 <= n; i += 4) {
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i));
+		if (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, t)))) return i;
+	}
+	return i;
+}
+#endif
+
+// Skips whole blocks that cannot enter the top k; returns where the scalar loop has to look again.
+inline size_t skipNotAbove(const int* v, size_t i, size_t n, int threshold, simd::Level level) {
+#if SIMD_X86
+	if (level >= simd::Level::AVX2) return skipNotAboveAVX2(v, i, n, threshold);
+	if (level >= simd::Level::SSE42) return skipNotAboveSSE(v, i, n, threshold);
+#else
+	(void)v; (void)n; (void)threshold; (void)level;
+#endif
+	return i;
+}
+
+} // namespace detail
+
+// The k best elements of a stream: Comp = std::less<> keeps the k largest.
+template <typename T, typename Comp = std::less<>>
+class TopK {
+private:
+	// the worst kept element has to be on top, so the heap orders by "better goes below"
+	struct Worse {
+		Comp comp;
+		bool operator()(const T& a, const T& b) const { return comp(b, a); }
+	};
+	DaryHeap<T, 4, Worse> heap_;
+	size_t k_;
+	Comp comp_;
+	simd::Level level_ = simd::cpuLevel();
+
+	static constexpr bool Filterable = std::is_same_v<T, int> && std::is_same_v<Comp, std::less<>>;
+
+public:
+	// expected: how many elements the stream will have, if known; the heap reserves min(k, expected).
+	explicit TopK(size_t k, Comp comp = {}, size_t expected = std::numeric_limits<size_t>::max())
+		: heap_(Worse{ comp }), k_(k), comp_(comp) {
+		heap_.reserve(std::min(k, expected));
+	}
+
+	// Only for benchmarks: compare the SIMD filter with the plain loop.
+	void setLevel(simd::Level level) { level_ = std::min(level, simd::cpuLevel()); }
+
+	size_t k() const { return k_; }
+	bool full() const { return heap_.size() == k_; }
+	// The worst element that is still in the top k (only meaningful when full()).
+	const T& threshold() const { return heap_.top(); }
+
+	void add(const T& x) {
+		if (heap_.size() < k_) heap_.push(x);
+		else if (k_ > 0 && comp_(heap_.top(), x)) heap_.replaceTop(x);
+	}
+
+	void add(std::span<const T> values) {
+		size_t i = 0, n = values.size();
+		for (; i < n && heap_.size() < k_; i++) heap_.push(values[i]);
+		if (k_ == 0) return;
+		if constexpr (Filterable) {
+			while (i < n) {
+				i = detail::skipNotAbove(values.data(), i, n, heap_.top(), level_);
+				// a block with at least one candidate (or the tail): scalar, the threshold rises as we go
+				for (size_t end = std::min(n, i + 8); i < end; i++) {
+					if (heap_.top() < values[i]) heap_.replaceTop(values[i]);
+				}
+			}
+		} else {
+			for (; i < n; i++) {
+				if (comp_(heap_.top(), values[i])) heap_.replaceTop(values[i]);
+			}
+		}
+	}
+
+	// The kept elements, best first; the TopK is empty afterwards.
+	std::vector<T> take() {
+		std::vector<T> out = heap_.release();
+		std::sort(out.begin(), out.end(), [this](const T& a, const T& b) { return comp_(b, a); });
+		return out;
+	}
+};
+
+template <typename T, typename Comp = std::less<>>
+std::vector<T> topK(std::span<const T> values, size_t k, Comp comp = {}) {
+	TopK<T, Comp> top(k, comp, values.size()); // a huge k over a short input does not allocate k
+	top.add(values);
+	return top.take();
+}
+
+} // namespace dheap
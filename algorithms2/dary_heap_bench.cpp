@@ -0,0 +1,112 @@
+// Benchmark: dheap::TopK against std::priority_queue / std::partial_sort_copy / std::partial_sort for
+// streaming top-K, and d-ary heaps against std::priority_queue under push/pop churn.
+// usage: dary_heap_bench [stream n=100000000] [churn heap size=1000000]
+//
+// top-K: the k largest of n random ints, k = 10 .. 100000, times in ms:
+//   priority_queue   : bounded std::priority_queue<int, vector, greater> (push, pop when over k)
+//   partial_sort_copy: std::partial_sort_copy into a k-element buffer (also a bounded heap)
+//   partial_sort     : copy the whole stream, std::partial_sort the first k
+//   TopK scalar/simd : dheap::TopK with the threshold filter off / on
+// churn: a heap of m random ints, then m * 4 rounds of pop + push; ns per round.
+//   IndexedDaryHeap also gets m * 4 update()s of random handles (decrease-key) in the same loop.
+// The stream is generated once in memory, so n = 1B needs 4 GB.
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <random>
+#include <cstdio>
+#include "dary_heap.h"
+#include "../common/bench_util.h"
+
+template <typename Heap>
+double churn(const std::vector<int>& init, const std::vector<int>& pushes) {
+	Heap heap;
+	for (int x : init) heap.push(x);
+	bench::Stopwatch sw;
+	long long sum = 0;
+	for (int x : pushes) {
+		sum += heap.top();
+		heap.pop();
+		heap.push(x);
+	}
+	bench::doNotOptimize(sum);
+	return sw.nanos() / pushes.size();
+}
+
+int main(int argc, char** argv) {
+	size_t n = static_cast<size_t>(bench::argOr(argc, argv, 1, 100000000));
+	size_t m = static_cast<size_t>(bench::argOr(argc, argv, 2, 1000000));
+	std::mt19937 rng(48);
+	std::vector<int> stream(n);
+	for (auto& x : stream) x = static_cast<int>(rng());
+	std::span<const int> values(stream);
+
+	std::printf("top-K of %zu ints (ms), best SIMD level: %s\n", n, simd::toString(simd::cpuLevel()));
+	std::printf("%7s %15s %18s %13s %12s %10s\n", "k", "priority_queue", "partial_sort_copy", "partial_sort", "TopK scalar", "TopK simd");
+	for (size_t k : { 10, 100, 1000, 10000, 100000 }) {
+		k = std::min(k, n);
+		bench::Stopwatch sw;
+		std::priority_queue<int, std::vector<int>, std::greater<int>> pq;
+		for (int x : values) {
+			if (pq.size() < k) pq.push(x);
+			else if (pq.top() < x) { pq.pop(); pq.push(x); }
+		}
+		double tPq = sw.seconds();
+		std::vector<int> expect;
+		while (!pq.empty()) { expect.push_back(pq.top()); pq.pop(); }
+		std::reverse(expect.begin(), expect.end());
+
+		sw.reset();
+		std::vector<int> psc(k);
+		std::partial_sort_copy(values.begin(), values.end(), psc.begin(), psc.end(), std::greater<int>());
+		double tPsc = sw.seconds();
+
+		sw.reset();
+		std::vector<int> all(values.begin(), values.end());
+		std::partial_sort(all.begin(), all.begin() + k, all.end(), std::greater<int>());
+		all.resize(k);
+		double tPs = sw.seconds();
+
+		sw.reset();
+		dheap::TopK<int> scalar(k);
+		scalar.setLevel(simd::Level::Scalar);
+		scalar.add(values);
+		std::vector<int> gotScalar = scalar.take();
+		double tScalar = sw.seconds();
+
+		sw.reset();
+		std::vector<int> gotSimd = dheap::topK(values, k);
+		double tSimd = sw.seconds();
+
+		bool ok = psc == expect && all == expect && gotScalar == expect && gotSimd == expect;
+		std::printf("%7zu %15.1f %18.1f %13.1f %12.1f %10.1f%s\n", k, tPq * 1e3, tPsc * 1e3, tPs * 1e3, tScalar * 1e3,
+			tSimd * 1e3, ok ? "" : "  MISMATCH");
+	}
+
+	std::vector<int> init(m), pushes(m * 4);
+	for (auto& x : init) x = static_cast<int>(rng());
+	for (auto& x : pushes) x = static_cast<int>(rng());
+	std::printf("\nchurn, heap of %zu (ns per pop + push)\n", m);
+	std::printf("  std::priority_queue %8.1f\n", churn<std::priority_queue<int>>(init, pushes));
+	std::printf("  DaryHeap<2>         %8.1f\n", churn<dheap::DaryHeap<int, 2>>(init, pushes));
+	std::printf("  DaryHeap<4>         %8.1f\n", churn<dheap::DaryHeap<int, 4>>(init, pushes));
+	std::printf("  DaryHeap<8>         %8.1f\n", churn<dheap::DaryHeap<int, 8>>(init, pushes));
+
+	// min-heap with decrease-key, Dijkstra style: every round also lowers a random live element.
+	// pop frees the top's handle and the next push reuses it, so the live handles stay 0 .. m-1.
+	dheap::IndexedDaryHeap<int, 4, std::greater<>> indexed;
+	for (int x : init) indexed.push(static_cast<int>(static_cast<uint32_t>(x) >> 2));
+	bench::Stopwatch sw;
+	long long sum = 0;
+	for (int x : pushes) {
+		uint32_t r = static_cast<uint32_t>(x);
+		auto h = static_cast<dheap::IndexedDaryHeap<int, 4, std::greater<>>::Handle>(r % m);
+		indexed.update(h, indexed.value(h) - static_cast<int>(r % 1000));
+		sum += indexed.top();
+		indexed.pop();
+		indexed.push(static_cast<int>(r >> 2));
+	}
+	bench::doNotOptimize(sum);
+	std::printf("  IndexedDaryHeap<4>  %8.1f (pop + push + decrease-key)\n", sw.nanos() / pushes.size());
+	return 0;
+}
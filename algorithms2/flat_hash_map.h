@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../common/simd_support.h"
+
+/*
+Flat open-addressing hash map for integer keys, Swiss-table style.
+ - std::unordered_map allocates one node per element and every bucket is a linked list: a lookup is
+   bucket array -> node -> (next node ...), i.e. 2+ cache misses, and ~40 bytes per int->int entry.
+ - Here keys and values live in one flat slot array. Next to it is one control byte per slot:
+   Empty, Deleted, or the low 7 bits of the key's hash (H2). The rest of the hash (H1) picks a group
+   of 16 slots; one SSE2 compare of the 16 control bytes against H2 gives the candidate slots, so a
+   lookup usually is one control-byte line + one slot line, and a miss stops at the first group with
+   an Empty byte.
+ - Groups are probed triangularly (g, g+1, g+3, g+6, ...), which visits every group of a power-of-two table.
+ - Max load is 7/8; reserve(n) sizes the table so n keys fit without rehashing.
+ - erase() leaves a Deleted marker (the probe chain must not break); rehashing drops them.
+ - Keys must be integers (hashed with a 64-bit mixer, so sequential or strided keys spread well).
+*/
+namespace hashing {
+
+namespace detail {
+
+// Final mixer of MurmurHash3 / splitmix64: every input bit affects every output bit.
+inline uint64_t mix(uint64_t x) {
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+constexpr size_t GroupSize = 16;
+constexpr int8_t Empty = -128;  // 0b10000000
+constexpr int8_t Deleted = -2;  // 0b11111110
+// full slots hold H2 in [0, 127], so "is full" is "sign bit clear"
+
+#if SIMD_X86
+SIMD_TARGET("sse2")
+inline uint32_t matchByte(const int8_t* group, int8_t b) {
+	__m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+	return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(b))));
+}
+#else
+inline uint32_t matchByte(const int8_t* group, int8_t b) {
+	uint32_t mask = 0;
+	for (size_t i = 0; i < GroupSize; i++) mask |= static_cast<uint32_t>(group[i] == b) << i;
+	return mask;
+}
+#endif
+
+// Control bytes, 16-byte aligned so a group is one aligned load.
+struct CtrlDeleter {
+	void operator()(int8_t* p) const { ::operator delete(p, std::align_val_t{ GroupSize }); }
+};
+using CtrlArray = std::unique_ptr<int8_t[], CtrlDeleter>;
+
+inline CtrlArray allocCtrl(size_t n) {
+	CtrlArray ctrl(static_cast<int8_t*>(::operator new(n, std::align_val_t{ GroupSize })));
+	std::memset(ctrl.get(), Empty, n);
+	return ctrl;
+}
+
+} // namespace detail
+
+template <typename K, typename V>
+class FlatIntMap {
+	static_assert(std::is_integral_v<K>, "FlatIntMap hashes integer keys");
+
+public:
+	struct Slot {
+		K key;
+		V value;
+	};
+
+private:
+	detail::CtrlArray ctrl_;
+	std::vector<Slot> slots_;
+	size_t capacity_ = 0; // slots, a power of two >= GroupSize (or 0 before the first insert)
+	size_t size_ = 0;
+	size_t deleted_ = 0;
+
+	static uint64_t hashOf(K key) { return detail::mix(static_cast<uint64_t>(key)); }
+	static int8_t h2(uint64_t h) { return static_cast<int8_t>(h & 0x7F); }
+	size_t groupMask() const { return capacity_ / detail::GroupSize - 1; }
+	size_t groupOf(uint64_t h) const { return static_cast<size_t>(h >> 7) & groupMask(); }
+	static size_t maxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+	// Slot index of key, or npos.
+	size_t findIndex(K key) const {
+		if (size_ == 0) return npos;
+		uint64_t h = hashOf(key);
+		int8_t tag = h2(h);
+		size_t g = groupOf(h);
+		for (size_t step = 1;; step++) {
+			const int8_t* group = ctrl_.get() + g * detail::GroupSize;
+			for (uint32_t m = detail::matchByte(group, tag); m; m &= m - 1) {
+				size_t i = g * detail::GroupSize + static_cast<size_t>(std::countr_zero(m));
+				if (slots_[i].key == key) return i;
+			}
+			if (detail::matchByte(group, detail::Empty)) return npos;
+			g = (g + step) & groupMask();
+		}
+	}
+
+	// First Empty or Deleted slot on key's probe sequence; the key is known to be absent.
+	size_t findFree(uint64_t h) const {
+		size_t g = groupOf(h);
+		for (size_t step = 1;; step++) {
+			const int8_t* group = ctrl_.get() + g * detail::GroupSize;
+			uint32_t m = detail::matchByte(group, detail::Empty) | detail::matchByte(group, detail::Deleted);
+			if (m) return g * detail::GroupSize + static_cast<size_t>(std::countr_zero(m));
+			g = (g + step) & groupMask();
+		}
+	}
+
+	void rehash(size_t newCapacity) {
+		detail::CtrlArray oldCtrl = std::move(ctrl_);
+		std::vector<Slot> oldSlots = std::move(slots_);
+		size_t oldCapacity = capacity_;
+		capacity_ = newCapacity;
+		ctrl_ = detail::allocCtrl(capacity_);
+		slots_ = std::vector<Slot>(capacity_);
+		deleted_ = 0;
+		for (size_t i = 0; i < oldCapacity; i++) {
+			if (oldCtrl[i] < 0) continue;
+			uint64_t h = hashOf(oldSlots[i].key);
+			size_t j = findFree(h);
+			ctrl_[j] = h2(h);
+			slots_[j] = std::move(oldSlots[i]);
+		}
+	}
+
+	static size_t capacityFor(size_t n) {
+		size_t cap = detail::GroupSize;
+		while (maxLoad(cap) < n) {
+			if (cap > std::numeric_limits<size_t>::max() / 2) throw std::length_error("FlatIntMap too large");
+			cap *= 2;
+		}
+		return cap;
+	}
+
+public:
+	static constexpr size_t npos = static_cast<size_t>(-1);
+
+	FlatIntMap() = default;
+	explicit FlatIntMap(size_t expected) { reserve(expected); }
+
+	FlatIntMap(FlatIntMap&& other) noexcept { *this = std::move(other); }
+	FlatIntMap& operator=(FlatIntMap&& other) noexcept {
+		ctrl_ = std::move(other.ctrl_);
+		slots_ = std::move(other.slots_);
+		capacity_ = std::exchange(other.capacity_, 0);
+		size_ = std::exchange(other.size_, 0);
+		deleted_ = std::exchange(other.deleted_, 0);
+		return *this;
+	}
+
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	size_t capacity() const { return capacity_; }
+	size_t memoryBytes() const { return capacity_ * (sizeof(Slot) + 1); }
+
+	// Makes room for n keys without rehashing.
+	void reserve(size_t n) {
+		size_t cap = capacityFor(n);
+		if (cap > capacity_) rehash(cap);
+	}
+
+	void clear() {
+		if (capacity_) std::memset(ctrl_.get(), detail::Empty, capacity_);
+		size_ = deleted_ = 0;
+	}
+
+	// Inserts {key, V{}} if key is absent; returns the value and whether it was inserted.
+	std::pair<V*, bool> tryEmplace(K key) {
+		if (size_t i = findIndex(key); i != npos) return { &slots_[i].value, false };
+		if (capacity_ == 0) rehash(detail::GroupSize);
+		else if (size_ + deleted_ + 1 > maxLoad(capacity_)) rehash(deleted_ >= size_ ? capacity_ : capacity_ * 2); // mostly tombstones: just drop them
+		uint64_t h = hashOf(key);
+		size_t i = findFree(h);
+		if (ctrl_[i] == detail::Deleted) deleted_--;
+		ctrl_[i] = h2(h);
+		slots_[i].key = key;
+		slots_[i].value = V{};
+		size_++;
+		return { &slots_[i].value, true };
+	}
+
+	V& operator[](K key) { return *tryEmplace(key).first; }
+
+	V* find(K key) {
+		size_t i = findIndex(key);
+		return i == npos ? nullptr : &slots_[i].value;
+	}
+	const V* find(K key) const {
+		size_t i = findIndex(key);
+		return i == npos ? nullptr : &slots_[i].value;
+	}
+	bool contains(K key) const { return findIndex(key) != npos; }
+
+	bool erase(K key) {
+		size_t i = findIndex(key);
+		if (i == npos) return false;
+		ctrl_[i] = detail::Deleted;
+		size_--;
+		deleted_++;
+		return true;
+	}
+
+	// fn(key, value) for every entry, in table order.
+	template <typename Fn>
+	void forEach(Fn&& fn) const {
+		for (size_t i = 0; i < capacity_; i++) {
+			if (ctrl_[i] >= 0) fn(slots_[i].key, slots_[i].value);
+		}
+	}
+};
+
+// Every value that occurs at least twice, with its count, in table (unspecified) order.
+// The map is sized for expectedDistinct keys up front (default: all of them distinct), so counting
+// never rehashes; pass a smaller estimate when the input is known to be mostly duplicates.
+template <typename T>
+std::vector<std::pair<T, uint32_t>> countDuplicates(std::span<const T> values, size_t expectedDistinct = std::numeric_limits<size_t>::max()) {
+	FlatIntMap<T, uint32_t> counts(std::min(expectedDistinct, values.size()));
+	for (const T& v : values) ++counts[v];
+	std::vector<std::pair<T, uint32_t>> dups;
+	counts.forEach([&](T key, uint32_t c) {
+		if (c >= 2) dups.push_back({ key, c });
+	});
+	return dups;
+}
+
+} // namespace hashing
@@ -0,0 +1,102 @@
+// Benchmark: hashing::FlatIntMap against std::unordered_map<int, int> - inserts, lookups, memory, and
+// the "find only the duplicates" task from algorithms2.cpp.
+// usage: flat_hash_map_bench [max n=100000000] [largest n for std::unordered_map=20000000]
+//
+// For n = 1M, 10M, 100M, 500M (up to max n):
+//   insert  : n distinct random keys into an empty map (no reserve, so rehashing is included)
+//   hit/miss: n lookups of present (shuffled) / absent keys, ns per lookup
+//   memory  : resident bytes the filled map added, per key
+//   dups    : n values drawn from [0, n/2), report every value seen twice or more;
+//             hashing::countDuplicates (pre-sized) vs the unordered_map loop; results compared
+// std::unordered_map needs ~40+ bytes per entry, so it is skipped above its size limit.
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <cstdio>
+#include "flat_hash_map.h"
+#include "../common/bench_util.h"
+
+struct Row {
+	double insertNs = 0, hitNs = 0, missNs = 0, bytesPerKey = 0, dupSec = 0;
+	std::vector<std::pair<int, uint32_t>> dups;
+};
+
+template <typename Map>
+Row run(const std::vector<int>& keys, const std::vector<int>& lookups, const std::vector<int>& absent, const std::vector<int>& dupInput, bool flat) {
+	Row row;
+	size_t n = keys.size();
+	{
+		size_t before = bench::residentBytes();
+		bench::Stopwatch sw;
+		Map map;
+		for (int k : keys) map[k] = k;
+		row.insertNs = sw.nanos() / n;
+		row.bytesPerKey = static_cast<double>(bench::residentBytes() - before) / n;
+
+		long long sum = 0;
+		sw.reset();
+		for (int k : lookups) {
+			auto it = map.find(k);
+			if constexpr (std::is_pointer_v<decltype(it)>) sum += *it;
+			else sum += it->second;
+		}
+		row.hitNs = sw.nanos() / n;
+		sw.reset();
+		for (int k : absent) {
+			if constexpr (std::is_pointer_v<decltype(map.find(k))>) sum += map.find(k) != nullptr;
+			else sum += map.find(k) != map.end();
+		}
+		row.missNs = sw.nanos() / n;
+		bench::doNotOptimize(sum);
+	}
+
+	bench::Stopwatch sw;
+	if (flat) {
+		row.dups = hashing::countDuplicates<int>(dupInput);
+	} else {
+		std::unordered_map<int, int> umap;
+		for (int v : dupInput) umap[v]++;
+		for (auto& it : umap) {
+			if (it.second >= 2) row.dups.push_back({ it.first, static_cast<uint32_t>(it.second) });
+		}
+	}
+	row.dupSec = sw.seconds();
+	std::sort(row.dups.begin(), row.dups.end());
+	return row;
+}
+
+int main(int argc, char** argv) {
+	size_t maxN = static_cast<size_t>(bench::argOr(argc, argv, 1, 100000000));
+	size_t stdLimit = static_cast<size_t>(bench::argOr(argc, argv, 2, 20000000));
+	std::mt19937 rng(46);
+	std::printf("%-11s %11s %9s %9s %9s %10s %9s\n", "map", "n", "insert ns", "hit ns", "miss ns", "bytes/key", "dups ms");
+
+	for (size_t n : { 1000000ull, 10000000ull, 100000000ull, 500000000ull }) {
+		if (n > maxN) break;
+		// distinct keys: a random odd multiplier permutes [0, 2^32), evens-only half for present keys
+		uint32_t mul = static_cast<uint32_t>(rng()) | 1;
+		std::vector<int> keys(n), absent(n), dupInput(n);
+		for (size_t i = 0; i < n; i++) {
+			keys[i] = static_cast<int>(static_cast<uint32_t>(2 * i) * mul);
+			absent[i] = static_cast<int>(static_cast<uint32_t>(2 * i + 1) * mul);
+		}
+		for (auto& v : dupInput) v = static_cast<int>(rng() % (n / 2));
+		std::vector<int> lookups = keys; // not in insertion order: unordered_map nodes sit in insertion order in memory
+		std::shuffle(lookups.begin(), lookups.end(), rng);
+
+		auto print = [&](const char* name, const Row& r, const char* note) {
+			std::printf("%-11s %11zu %9.1f %9.1f %9.1f %10.1f %9.1f%s\n", name, n, r.insertNs, r.hitNs, r.missNs,
+				r.bytesPerKey, r.dupSec * 1e3, note);
+		};
+		Row flat = run<hashing::FlatIntMap<int, int>>(keys, lookups, absent, dupInput, true);
+		if (n <= stdLimit) {
+			Row stl = run<std::unordered_map<int, int>>(keys, lookups, absent, dupInput, false);
+			print("unordered", stl, "");
+			print("FlatIntMap", flat, flat.dups == stl.dups ? "" : "  MISMATCH");
+		} else {
+			print("FlatIntMap", flat, "");
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,328 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../common/simd_support.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+Merging k sorted runs into one (external sort output, posting lists from k shards, ...).
+ - Repeated std::merge (pairwise rounds) reads and writes every element log2(k) times.
+ - A std::priority_queue of heads pops + pushes per element: ~2 log2(k) compares, and a pop
+   moves elements around the whole heap.
+ - Loser tree (tournament tree): leaves are the runs, every inner node remembers the loser of the
+   match played there, the overall winner sits on top. After the winner is output only its own
+   leaf-to-root path is replayed: exactly log2(k) compares, no swaps of big elements, and the path
+   is the same few cache lines every time.
+ - Buffered, cache-sized input blocks: each run is read in blocks of about 512 KB / k bytes. Entering
+   a block prefetches the next one, so with k = 1000 streams (far more than the hardware prefetcher
+   tracks) the next data is already on its way. For memory-mapped runs the kernel is told to read ahead.
+ - The head of every run is copied into the tree next to its run index, so a replay never touches the
+   runs themselves. For 32-bit ints with the default order key and run are packed into one uint64_t
+   and a match is a single unsigned min/max (no mispredicted branch per level).
+ - Repeated std::merge stays a strong baseline for small k when everything fits in memory (each pass is
+   one branch per element, streamed); the tree wins on memory traffic and needs no temporary runs.
+ - Ties are won by the lower run index, so the merge is stable. dedup = true keeps only the first of
+   every group of equal elements, i.e. the same result as std::unique on the merged output.
+ - Runs are spans, so they can point into vectors or into MappedRun files.
+*/
+namespace kmerge {
+
+// A file of raw T values (e.g. written by writeRun), mapped read-only into memory.
+template <typename T>
+class MappedRun {
+private:
+	const T* data_ = nullptr;
+	size_t count_ = 0;
+#ifdef _WIN32
+	HANDLE file_ = INVALID_HANDLE_VALUE, mapping_ = nullptr;
+#else
+	size_t bytes_ = 0;
+#endif
+
+public:
+	explicit MappedRun(const std::string& path) {
+#ifdef _WIN32
+		file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+		LARGE_INTEGER size;
+		GetFileSizeEx(file_, &size);
+		count_ = static_cast<size_t>(size.QuadPart) / sizeof(T);
+		if (count_ == 0) return;
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping_) throw std::runtime_error("cannot map " + path);
+		data_ = static_cast<const T*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+		if (!data_) throw std::runtime_error("cannot map " + path);
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw std::runtime_error("cannot open " + path);
+		struct stat st {};
+		fstat(fd, &st);
+		bytes_ = static_cast<size_t>(st.st_size);
+		count_ = bytes_ / sizeof(T);
+		if (bytes_ > 0) {
+			void* p = mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p == MAP_FAILED) {
+				::close(fd);
+				throw std::runtime_error("cannot map " + path);
+			}
+			madvise(p, bytes_, MADV_SEQUENTIAL); // read ahead, drop pages behind
+			data_ = static_cast<const T*>(p);
+		}
+		::close(fd); // the mapping keeps the file alive
+#endif
+	}
+
+	~MappedRun() {
+#ifdef _WIN32
+		if (data_) UnmapViewOfFile(data_);
+		if (mapping_) CloseHandle(mapping_);
+		if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+		if (data_) munmap(const_cast<T*>(data_), bytes_);
+#endif
+	}
+
+	MappedRun(const MappedRun&) = delete;
+	MappedRun& operator=(const MappedRun&) = delete;
+
+	std::span<const T> span() const { return { data_, count_ }; }
+};
+
+// Writes a run as raw T values, the format MappedRun reads.
+template <typename T>
+void writeRun(const std::string& path, std::span<const T> run) {
+	FILE* f = std::fopen(path.c_str(), "wb");
+	if (!f) throw std::runtime_error("cannot write " + path);
+	size_t written = std::fwrite(run.data(), sizeof(T), run.size(), f);
+	std::fclose(f);
+	if (written != run.size()) throw std::runtime_error("short write to " + path);
+}
+
+constexpr size_t CacheBudgetBytes = 512 * 1024; // for all runs' current blocks together
+
+namespace detail {
+
+// Touches every cache line of [from, min(from + count, end)).
+template <typename T>
+void prefetchBlock(const T* from, const T* end, size_t count) {
+	const char* p = reinterpret_cast<const char*>(from);
+	const char* stop = reinterpret_cast<const char*>(from + std::min<size_t>(count, static_cast<size_t>(end - from)));
+	for (; p < stop; p += 64) {
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(p);
+#elif SIMD_X86
+		_mm_prefetch(p, _MM_HINT_T0);
+#endif
+	}
+}
+
+} // namespace detail
+
+template <typename T, typename Comp = std::less<>>
+class LoserTree {
+private:
+	struct Cursor {
+		const T* cur;
+		const T* end;
+		const T* blockEnd; // entering the next block prefetches the one after it
+	};
+	// A match participant: the head value is copied into the tree, so replaying a path reads only the
+	// tree's own cache lines, not k different runs.
+	struct Entry {
+		T key;
+		uint32_t run;
+		bool done; // run exhausted: loses against everything
+	};
+	std::vector<Cursor> runs_;
+	std::vector<Entry> tree_; // tree_[0] = winner, tree_[1..leaves) = loser of each match
+	size_t leaves_ = 1;
+	size_t blockElems_ = 64;
+	Comp comp_;
+
+	// true when a goes out before b; ties go to the lower run
+	bool beats(const Entry& a, const Entry& b) const {
+		if (a.done | b.done) return b.done && (!a.done || a.run < b.run);
+		if (comp_(a.key, b.key)) return true;
+		if (comp_(b.key, a.key)) return false;
+		return a.run < b.run;
+	}
+
+	Entry head(uint32_t r) const {
+		if (r >= runs_.size() || runs_[r].cur == runs_[r].end) return { T{}, r, true };
+		return { *runs_[r].cur, r, false };
+	}
+
+	Entry build(size_t node) {
+		if (node >= leaves_) return head(static_cast<uint32_t>(node - leaves_));
+		Entry l = build(2 * node), r = build(2 * node + 1);
+		if (beats(l, r)) { tree_[node] = r; return l; }
+		tree_[node] = l;
+		return r;
+	}
+
+public:
+	explicit LoserTree(std::span<const std::span<const T>> runs, Comp comp = {}) : comp_(comp) {
+		for (auto r : runs) runs_.push_back({ r.data(), r.data() + r.size(), r.data() });
+		while (leaves_ < runs_.size()) leaves_ *= 2;
+		blockElems_ = std::max<size_t>(64 / sizeof(T) + 1, CacheBudgetBytes / sizeof(T) / std::max<size_t>(1, runs_.size()));
+		for (Cursor& c : runs_) {
+			c.blockEnd = std::min(c.cur + blockElems_, c.end);
+			detail::prefetchBlock(c.cur, c.end, blockElems_);
+			detail::prefetchBlock(c.blockEnd, c.end, blockElems_);
+		}
+		tree_.resize(leaves_);
+		tree_[0] = build(1);
+	}
+
+	bool empty() const { return tree_[0].done; }
+	const T& top() const { return tree_[0].key; }
+
+	// Replaces the current winner by the next element of its run and replays its path to the root.
+	void pop() {
+		uint32_t r = tree_[0].run;
+		Cursor& c = runs_[r];
+		if (++c.cur == c.blockEnd && c.cur != c.end) {
+			c.blockEnd = std::min(c.cur + blockElems_, c.end);
+			detail::prefetchBlock(c.blockEnd, c.end, blockElems_);
+		}
+		Entry w = c.cur == c.end ? Entry{ T{}, r, true } : Entry{ *c.cur, r, false };
+		for (size_t node = (r + leaves_) / 2; node > 0; node /= 2) {
+			if (beats(tree_[node], w)) std::swap(tree_[node], w);
+		}
+		tree_[0] = w;
+	}
+};
+
+namespace detail {
+
+// Loser tree for 32-bit integers with the default order: a participant is one uint64_t,
+// (key with the sign bit flipped) << 32 | run, so "a beats b" including the tie-break on the run
+// is a single unsigned compare and a match is a min/max pair (cmov) instead of a coin-flip branch.
+// Exhausted runs are ~0, which loses to every real key; the caller stops after the total count.
+template <typename T>
+class PackedLoserTree {
+private:
+	static constexpr uint64_t Exhausted = ~uint64_t{ 0 };
+	static constexpr uint32_t SignFlip = std::is_signed_v<T> ? 0x80000000u : 0u;
+
+	std::vector<const T*> cur_, end_, blockEnd_;
+	std::vector<uint64_t> tree_;
+	size_t leaves_ = 1;
+	size_t blockElems_ = 64;
+
+	uint64_t head(size_t r) const {
+		if (r >= cur_.size() || cur_[r] == end_[r]) return Exhausted;
+		return (static_cast<uint64_t>(static_cast<uint32_t>(*cur_[r]) ^ SignFlip) << 32) | r;
+	}
+
+	uint64_t build(size_t node) {
+		if (node >= leaves_) return head(node - leaves_);
+		uint64_t l = build(2 * node), r = build(2 * node + 1);
+		tree_[node] = std::max(l, r);
+		return std::min(l, r);
+	}
+
+public:
+	explicit PackedLoserTree(std::span<const std::span<const T>> runs) {
+		for (auto r : runs) {
+			cur_.push_back(r.data());
+			end_.push_back(r.data() + r.size());
+		}
+		while (leaves_ < cur_.size()) leaves_ *= 2;
+		blockElems_ = std::max<size_t>(64 / sizeof(T) + 1, CacheBudgetBytes / sizeof(T) / std::max<size_t>(1, cur_.size()));
+		for (size_t r = 0; r < cur_.size(); r++) {
+			blockEnd_.push_back(std::min(cur_[r] + blockElems_, end_[r]));
+			prefetchBlock(cur_[r], end_[r], blockElems_);
+			prefetchBlock(blockEnd_[r], end_[r], blockElems_);
+		}
+		tree_.resize(leaves_);
+		tree_[0] = build(1);
+	}
+
+	T top() const { return static_cast<T>(static_cast<uint32_t>(tree_[0] >> 32) ^ SignFlip); }
+
+	void pop() {
+		size_t r = static_cast<uint32_t>(tree_[0]);
+		if (++cur_[r] == blockEnd_[r] && cur_[r] != end_[r]) {
+			blockEnd_[r] = std::min(cur_[r] + blockElems_, end_[r]);
+			prefetchBlock(blockEnd_[r], end_[r], blockElems_);
+		}
+		uint64_t w = head(r);
+		for (size_t node = (r + leaves_) / 2; node > 0; node /= 2) {
+			uint64_t stored = tree_[node];
+			tree_[node] = std::max(stored, w);
+			w = std::min(stored, w);
+		}
+		tree_[0] = w;
+	}
+};
+
+template <typename T, typename Comp>
+constexpr bool Packable = std::is_integral_v<T> && sizeof(T) == 4
+	&& (std::is_same_v<Comp, std::less<>> || std::is_same_v<Comp, std::less<T>>);
+
+} // namespace detail
+
+// Merges all runs into out (room for the sum of the run sizes); returns the number written.
+template <typename T, typename Comp = std::less<>>
+size_t merge(std::span<const std::span<const T>> runs, T* out, bool dedup = false, Comp comp = {}) {
+	if (runs.empty()) return 0;
+	if (runs.size() == 1 && !dedup) return static_cast<size_t>(std::copy(runs[0].begin(), runs[0].end(), out) - out);
+	size_t k = 0;
+	if constexpr (detail::Packable<T, Comp>) {
+		if (runs.size() < 0xFFFFFFFFu) {
+			size_t total = 0;
+			for (auto r : runs) total += r.size();
+			detail::PackedLoserTree<T> tree(runs);
+			for (size_t i = 0; i < total; i++) {
+				T x = tree.top();
+				if (!dedup || k == 0 || out[k - 1] < x) out[k++] = x;
+				tree.pop();
+			}
+			return k;
+		}
+	}
+	LoserTree<T, Comp> tree(runs, comp);
+	if (dedup) {
+		while (!tree.empty()) {
+			const T& x = tree.top();
+			if (k == 0 || comp(out[k - 1], x)) out[k++] = x; // equal to the last one written: skip
+			tree.pop();
+		}
+	} else {
+		while (!tree.empty()) {
+			out[k++] = tree.top();
+			tree.pop();
+		}
+	}
+	return k;
+}
+
+template <typename T, typename Comp = std::less<>>
+std::vector<T> merge(std::span<const std::span<const T>> runs, bool dedup = false, Comp comp = {}) {
+	size_t total = 0;
+	for (auto r : runs) total += r.size();
+	std::vector<T> out(total);
+	out.resize(merge(runs, out.data(), dedup, comp));
+	return out;
+}
+
+} // namespace kmerge
@@ -0,0 +1,109 @@
+// Benchmark: k-way merge of sorted runs - loser tree vs repeated std::merge vs std::priority_queue.
+// usage: kway_merge_bench [total elements=16777216] [max k=1024]
+//
+// The same total amount of data is split into k sorted runs of random ints, k = 2, 4, ... max k.
+//   std::merge rounds : merge runs pairwise, log2(k) passes over all the data
+//   priority_queue    : std::priority_queue of (head value, run index)
+//   loser tree        : kmerge::merge on in-memory spans
+//   loser tree mmap   : the same runs written to files and read through kmerge::MappedRun
+//   dedup             : kmerge::merge(..., dedup = true), checked against std::unique
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <random>
+#include <string>
+#include <memory>
+#include <cstdio>
+#include "kway_merge.h"
+#include "../common/bench_util.h"
+
+std::vector<int> mergeRounds(std::vector<std::vector<int>> runs) {
+	while (runs.size() > 1) {
+		std::vector<std::vector<int>> next;
+		for (size_t r = 0; r + 1 < runs.size(); r += 2) {
+			std::vector<int> m(runs[r].size() + runs[r + 1].size());
+			std::merge(runs[r].begin(), runs[r].end(), runs[r + 1].begin(), runs[r + 1].end(), m.begin());
+			next.push_back(std::move(m));
+		}
+		if (runs.size() % 2) next.push_back(std::move(runs.back()));
+		runs.swap(next);
+	}
+	return std::move(runs[0]);
+}
+
+std::vector<int> mergeHeap(const std::vector<std::span<const int>>& runs, size_t total) {
+	using Head = std::pair<int, uint32_t>; // (value, run) - ties pop the lower run first, like the loser tree
+	std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+	std::vector<size_t> pos(runs.size(), 0);
+	for (uint32_t r = 0; r < runs.size(); r++) if (!runs[r].empty()) heap.push({ runs[r][0], r });
+	std::vector<int> out;
+	out.reserve(total);
+	while (!heap.empty()) {
+		auto [v, r] = heap.top();
+		heap.pop();
+		out.push_back(v);
+		if (++pos[r] < runs[r].size()) heap.push({ runs[r][pos[r]], r });
+	}
+	return out;
+}
+
+int main(int argc, char** argv) {
+	size_t total = static_cast<size_t>(bench::argOr(argc, argv, 1, 16 << 20));
+	size_t maxK = static_cast<size_t>(bench::argOr(argc, argv, 2, 1024));
+	std::mt19937 rng(21);
+	std::printf("%zu elements in total, M elements/s\n", total);
+	std::printf("%6s %16s %16s %12s %16s %10s\n", "k", "std::merge rnds", "priority_queue", "loser tree", "loser tree mmap", "dedup");
+
+	for (size_t k = 2; k <= maxK; k *= 2) {
+		std::vector<std::vector<int>> runs(k);
+		for (auto& r : runs) {
+			r.resize(total / k);
+			for (auto& x : r) x = static_cast<int>(rng() % (total * 2)); // some duplicates across runs
+			std::sort(r.begin(), r.end());
+		}
+		std::vector<std::span<const int>> spans(runs.begin(), runs.end());
+		size_t n = total / k * k;
+
+		bench::Stopwatch sw;
+		std::vector<int> expect = mergeRounds(runs);
+		double tRounds = sw.seconds();
+
+		sw.reset();
+		std::vector<int> heapOut = mergeHeap(spans, n);
+		double tHeap = sw.seconds();
+
+		sw.reset();
+		std::vector<int> tree = kmerge::merge<int>(spans);
+		double tTree = sw.seconds();
+
+		std::vector<std::string> paths;
+		for (size_t r = 0; r < k; r++) {
+			paths.push_back("kway_run_" + std::to_string(r) + ".bin");
+			kmerge::writeRun<int>(paths.back(), runs[r]);
+		}
+		sw.reset();
+		std::vector<int> mapped;
+		{
+			std::vector<std::unique_ptr<kmerge::MappedRun<int>>> files;
+			std::vector<std::span<const int>> fileSpans;
+			for (auto& p : paths) {
+				files.push_back(std::make_unique<kmerge::MappedRun<int>>(p));
+				fileSpans.push_back(files.back()->span());
+			}
+			mapped = kmerge::merge<int>(fileSpans);
+		}
+		double tMapped = sw.seconds();
+		for (auto& p : paths) std::remove(p.c_str());
+
+		sw.reset();
+		std::vector<int> unique = kmerge::merge<int>(spans, true);
+		double tDedup = sw.seconds();
+		std::vector<int> expectUnique = expect;
+		expectUnique.erase(std::unique(expectUnique.begin(), expectUnique.end()), expectUnique.end());
+
+		bool ok = heapOut == expect && tree == expect && mapped == expect && unique == expectUnique;
+		std::printf("%6zu %16.1f %16.1f %12.1f %16.1f %10.1f%s\n", k, n / tRounds / 1e6, n / tHeap / 1e6, n / tTree / 1e6,
+			n / tMapped / 1e6, n / tDedup / 1e6, ok ? "" : "  MISMATCH");
+	}
+	return 0;
+}
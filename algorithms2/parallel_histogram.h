@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+#include "flat_hash_map.h"
+#include "../common/thread_pool.h"
+
+/*
+Parallel histogram / duplicate detection for big int arrays, without shared tables or locks.
+ - One shared hash map would need a lock or atomics on every insert, and every thread's writes would
+   bounce the same cache lines between cores. One map per thread avoids that but then every map
+   holds (almost) every key and they still have to be merged.
+ - Instead the input is radix-partitioned by the top bits of its hash, so equal values always land
+   in the same partition:
+     1. every chunk of the input counts how many of its values go to each partition,
+     2. a prefix sum over (partition, chunk) gives each chunk its own write offsets,
+     3. every chunk scatters its values to those offsets (disjoint ranges: no synchronization),
+     4. partitions are counted independently, each in a FlatIntMap sized for about
+        PartitionKeys keys (fits in L2), workers pulling the next partition from an atomic counter
+        so one hot partition (skewed input) does not hold up a whole static range,
+     5. per-partition results are concatenated at prefix-sum offsets.
+ - Partition count is a power of two, at most MaxPartitions, so the scatter writes to few enough
+   places at once for the TLB and write buffers.
+ - Results come out grouped by partition: no particular order. With pool == nullptr everything
+   runs on the calling thread (still partitioned, the tables stay cache-sized).
+*/
+namespace hashing {
+
+constexpr size_t PartitionKeys = 1 << 15;  // input values per partition when choosing the partition count
+constexpr size_t MaxPartitions = 1 << 10;
+
+namespace detail {
+
+inline size_t partitionBits(size_t n) {
+	size_t parts = std::bit_ceil(std::max<size_t>(1, n / PartitionKeys));
+	return static_cast<size_t>(std::countr_zero(std::min(parts, MaxPartitions)));
+}
+
+// Counts every value and keeps the ones seen at least minCount times.
+template <typename T>
+std::vector<std::pair<T, uint64_t>> countPartitioned(std::span<const T> values, size_t minCount, ThreadPool* pool) {
+	size_t n = values.size();
+	size_t bits = partitionBits(n);
+	size_t parts = size_t{ 1 } << bits;
+	auto partOf = [bits](T v) { return bits ? static_cast<size_t>(mix(static_cast<uint64_t>(v)) >> (64 - bits)) : 0; };
+
+	size_t chunks = pool ? std::max<size_t>(1, std::min<size_t>(pool->size() + 1, n / PartitionKeys)) : 1;
+	size_t chunkLen = (n + chunks - 1) / std::max<size_t>(1, chunks);
+	auto forChunks = [&](auto&& fn) {
+		if (pool) pool->parallel_for(0, chunks, 1, [&](size_t lo, size_t hi) { for (size_t c = lo; c < hi; c++) fn(c); });
+		else for (size_t c = 0; c < chunks; c++) fn(c);
+	};
+
+	// 1. per-chunk partition sizes, 2. offsets: partition-major, so each partition ends up contiguous
+	std::vector<size_t> offset(chunks * parts, 0);
+	forChunks([&](size_t c) {
+		size_t* counts = offset.data() + c * parts;
+		for (size_t i = c * chunkLen, end = std::min(n, i + chunkLen); i < end; i++) counts[partOf(values[i])]++;
+	});
+	std::vector<size_t> partBegin(parts + 1, 0);
+	size_t sum = 0;
+	for (size_t p = 0; p < parts; p++) {
+		partBegin[p] = sum;
+		for (size_t c = 0; c < chunks; c++) {
+			size_t cnt = offset[c * parts + p];
+			offset[c * parts + p] = sum;
+			sum += cnt;
+		}
+	}
+	partBegin[parts] = sum;
+
+	// 3. scatter
+	std::vector<T> scattered(parts > 1 ? n : 0);
+	std::span<const T> partitioned = values;
+	if (parts > 1) {
+		forChunks([&](size_t c) {
+			size_t* next = offset.data() + c * parts;
+			for (size_t i = c * chunkLen, end = std::min(n, i + chunkLen); i < end; i++) scattered[next[partOf(values[i])]++] = values[i];
+		});
+		partitioned = scattered;
+	}
+
+	// 4. count each partition in its own small table
+	std::vector<std::vector<std::pair<T, uint64_t>>> found(parts);
+	std::atomic<size_t> nextPart{ 0 };
+	auto worker = [&] {
+		FlatIntMap<T, uint64_t> counts;
+		for (size_t p; (p = nextPart.fetch_add(1, std::memory_order_relaxed)) < parts;) {
+			std::span<const T> part = partitioned.subspan(partBegin[p], partBegin[p + 1] - partBegin[p]);
+			size_t expected = std::min(part.size(), PartitionKeys);
+			if (counts.capacity() > 8 * expected + 64) counts = FlatIntMap<T, uint64_t>(expected); // after a hot partition
+			else counts.clear();
+			counts.reserve(expected);
+			for (const T& v : part) ++counts[v];
+			counts.forEach([&](T key, uint64_t c) {
+				if (c >= minCount) found[p].push_back({ key, c });
+			});
+		}
+	};
+	if (pool) pool->parallel_for(0, pool->size() + 1, 1, [&](size_t lo, size_t hi) { for (size_t w = lo; w < hi; w++) worker(); });
+	else worker();
+
+	// 5. concatenate
+	std::vector<size_t> outBegin(parts + 1, 0);
+	for (size_t p = 0; p < parts; p++) outBegin[p + 1] = outBegin[p] + found[p].size();
+	std::vector<std::pair<T, uint64_t>> out(outBegin[parts]);
+	auto copyParts = [&](size_t lo, size_t hi) {
+		for (size_t p = lo; p < hi; p++) std::copy(found[p].begin(), found[p].end(), out.begin() + outBegin[p]);
+	};
+	if (pool) pool->parallel_for(0, parts, 16, copyParts);
+	else copyParts(0, parts);
+	return out;
+}
+
+} // namespace detail
+
+// (value, count) for every distinct value, in no particular order.
+template <typename T>
+std::vector<std::pair<T, uint64_t>> histogram(std::span<const T> values, ThreadPool* pool = nullptr) {
+	return detail::countPartitioned(values, 1, pool);
+}
+
+// Every value that occurs at least twice, once each, in no particular order.
+template <typename T>
+std::vector<T> findDuplicates(std::span<const T> values, ThreadPool* pool = nullptr) {
+	auto counted = detail::countPartitioned(values, 2, pool);
+	std::vector<T> dups(counted.size());
+	std::transform(counted.begin(), counted.end(), dups.begin(), [](const auto& kv) { return kv.first; });
+	return dups;
+}
+
+} // namespace hashing
@@ -0,0 +1,64 @@
+// Benchmark: hashing::findDuplicates / histogram (radix-partitioned, per-partition tables) for 1..64 threads,
+// on uniform and Zipf-skewed inputs.
+// usage: parallel_histogram_bench [n=50000000] [max threads=64]
+//
+// Inputs have n values from a universe of n/2:
+//   uniform : every value equally likely
+//   zipf    : value k with probability ~1/k (floor(m^u) for uniform u), so a few values take a big share
+// Baseline is hashing::countDuplicates from flat_hash_map.h (one table for everything, one thread).
+// Each thread count gets its own ThreadPool of t-1 workers (the calling thread is the t-th).
+// Results are compared with the baseline after sorting.
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <thread>
+#include <cstdio>
+#include "parallel_histogram.h"
+#include "../common/bench_util.h"
+
+int main(int argc, char** argv) {
+	size_t n = static_cast<size_t>(bench::argOr(argc, argv, 1, 50000000));
+	unsigned maxThreads = static_cast<unsigned>(bench::argOr(argc, argv, 2, 64));
+	size_t universe = std::max<size_t>(1, n / 2);
+	std::mt19937_64 rng(47);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::printf("n = %zu, hardware threads: %u, M values/s\n", n, std::thread::hardware_concurrency());
+
+	std::vector<int> uniform(n), zipf(n);
+	for (auto& v : uniform) v = static_cast<int>(rng() % universe);
+	for (auto& v : zipf) v = static_cast<int>(std::min<double>(universe - 1, std::floor(std::pow(static_cast<double>(universe), unit(rng))) - 1));
+
+	for (auto* input : { &uniform, &zipf }) {
+		const char* name = input == &uniform ? "uniform" : "zipf";
+		std::span<const int> values(*input);
+
+		bench::Stopwatch sw;
+		auto base = hashing::countDuplicates(values);
+		double tBase = sw.seconds();
+		std::vector<int> expect(base.size());
+		std::transform(base.begin(), base.end(), expect.begin(), [](const auto& kv) { return kv.first; });
+		std::sort(expect.begin(), expect.end());
+		std::printf("%-8s %-22s %8.1f (%zu duplicated values)\n", name, "countDuplicates", n / tBase / 1e6, expect.size());
+
+		double tOne = 0;
+		for (unsigned t = 1; t <= maxThreads; t *= 2) {
+			ThreadPool pool(t - 1);
+			sw.reset();
+			std::vector<int> dups = hashing::findDuplicates(values, &pool);
+			double tDups = sw.seconds();
+			sw.reset();
+			auto hist = hashing::histogram(values, &pool);
+			double tHist = sw.seconds();
+			if (t == 1) tOne = tDups;
+
+			std::sort(dups.begin(), dups.end());
+			uint64_t total = 0;
+			for (auto& kv : hist) total += kv.second;
+			bool ok = dups == expect && total == n;
+			std::printf("%-8s findDuplicates t=%-5u %8.1f  speedup %5.2fx   histogram %8.1f%s\n", name, t, n / tDups / 1e6,
+				tOne / tDups, n / tHist / 1e6, ok ? "" : "  MISMATCH");
+		}
+	}
+	return 0;
+}
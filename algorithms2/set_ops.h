@@ -0,0 +1,321 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "../common/simd_support.h"
+#include "../common/thread_pool.h"
+
+/*
+Union / intersection / difference of sorted sets (posting lists of IDs), like std::set_union in
+algorithms2.cpp but for tens of millions of elements.
+Inputs must be sorted and duplicate-free (real sets); outputs are the same.
+ - setUnion(a, b) etc. return a std::vector already trimmed to size, instead of the
+   "result(10) ... result.resize(itr - result.begin())" dance. The ...Into() versions write to a
+   caller buffer of capacityFor...() elements and return the count.
+ - Similar sizes, int keys: SIMD block compare (SSE4.2). 4 ints of a are compared against 4 ints of b
+   in all 4 rotations at once; whichever block has the smaller last element moves on. Matches are
+   remembered per a-block and the block is written with one shuffle when it is retired.
+ - Similar sizes otherwise (and union): branchless scalar merge, one compare per output element.
+ - Skewed sizes (ratio >= 32, >= 8 for union): galloping. Every element of the small set does an exponential search
+   (1, 2, 4, ... steps) in the big one from where the previous one stopped, and the runs in between
+   are copied in bulk: O(small * log(big / small)) instead of O(small + big).
+ - pool != nullptr: both inputs are cut at the same values (splitters taken from the bigger input,
+   lower_bound in both), so every piece is an independent smaller problem. Pieces run on the pool,
+   each into its own worst-case slot of the output, and are then packed together.
+*/
+namespace setops {
+
+constexpr size_t GallopRatio = 32;
+constexpr size_t UnionGallopRatio = 8; // union copies the big side anyway, so galloping pays off sooner
+constexpr size_t MaxPieces = 256;    // parallel mode
+constexpr size_t SimdSlack = 4;      // the SIMD block compare stores 4 ints at a time
+
+namespace detail {
+
+// first index >= from with arr[idx] >= x, exponential search then binary search
+template <typename T>
+size_t gallop(const T* arr, size_t n, size_t from, const T& x) {
+	if (from >= n || !(arr[from] < x)) return from;
+	size_t lo = from, step = 1, hi = from + 1;
+	while (hi < n && arr[hi] < x) {
+		lo = hi;
+		step *= 2;
+		hi = std::min(n, lo + step);
+	}
+	return static_cast<size_t>(std::lower_bound(arr + lo + 1, arr + hi, x) - arr);
+}
+
+// ---------- scalar merges ----------
+
+template <typename T>
+size_t unionMerge(const T* a, size_t na, const T* b, size_t nb, T* out) {
+	size_t i = 0, j = 0, k = 0;
+	while (i < na && j < nb) {
+		T x = a[i], y = b[j];
+		out[k++] = y < x ? y : x;
+		i += !(y < x);
+		j += !(x < y);
+	}
+	out = std::copy(a + i, a + na, out + k);
+	std::copy(b + j, b + nb, out);
+	return k + (na - i) + (nb - j);
+}
+
+template <typename T>
+size_t intersectMerge(const T* a, size_t na, const T* b, size_t nb, T* out, size_t i = 0, size_t j = 0, size_t k = 0) {
+	while (i < na && j < nb) {
+		T x = a[i], y = b[j];
+		out[k] = x;
+		k += !(x < y) && !(y < x);
+		i += !(y < x);
+		j += !(x < y);
+	}
+	return k;
+}
+
+template <typename T>
+size_t differenceMerge(const T* a, size_t na, const T* b, size_t nb, T* out, size_t i = 0, size_t j = 0, size_t k = 0) {
+	while (i < na && j < nb) {
+		T x = a[i], y = b[j];
+		out[k] = x;
+		k += x < y;
+		i += !(y < x);
+		j += !(x < y);
+	}
+	std::copy(a + i, a + na, out + k);
+	return k + (na - i);
+}
+
+// ---------- galloping (skewed sizes) ----------
+
+template <typename T>
+size_t unionGallop(const T* small, size_t ns, const T* big, size_t nb, T* out) {
+	size_t pos = 0, k = 0;
+	for (size_t s = 0; s < ns; s++) {
+		size_t p = gallop(big, nb, pos, small[s]);
+		std::copy(big + pos, big + p, out + k);
+		k += p - pos;
+		out[k++] = small[s];
+		pos = p + (p < nb && !(small[s] < big[p])); // skip the twin in big
+	}
+	std::copy(big + pos, big + nb, out + k);
+	return k + (nb - pos);
+}
+
+template <typename T>
+size_t intersectGallop(const T* small, size_t ns, const T* big, size_t nb, T* out) {
+	size_t pos = 0, k = 0;
+	for (size_t s = 0; s < ns && pos < nb; s++) {
+		pos = gallop(big, nb, pos, small[s]);
+		out[k] = small[s];
+		k += pos < nb && !(small[s] < big[pos]);
+	}
+	return k;
+}
+
+// a \ b with a much smaller than b
+template <typename T>
+size_t differenceGallopSmallA(const T* a, size_t na, const T* b, size_t nb, T* out) {
+	size_t pos = 0, k = 0;
+	for (size_t i = 0; i < na; i++) {
+		pos = gallop(b, nb, pos, a[i]);
+		out[k] = a[i];
+		k += !(pos < nb && !(a[i] < b[pos]));
+	}
+	return k;
+}
+
+// a \ b with b much smaller than a: copy the runs of a between the elements of b
+template <typename T>
+size_t differenceGallopSmallB(const T* a, size_t na, const T* b, size_t nb, T* out) {
+	size_t pos = 0, k = 0;
+	for (size_t j = 0; j < nb; j++) {
+		size_t p = gallop(a, na, pos, b[j]);
+		std::copy(a + pos, a + p, out + k);
+		k += p - pos;
+		pos = p + (p < na && !(b[j] < a[p]));
+	}
+	std::copy(a + pos, a + na, out + k);
+	return k + (na - pos);
+}
+
+// ---------- SIMD block compare (int) ----------
+
+#if SIMD_X86
+// shuffle masks that pack the 32-bit lanes selected by a 4-bit mask to the front
+struct PackTable {
+	alignas(16) uint8_t bytes[16][16];
+	constexpr PackTable() : bytes{} {
+		for (unsigned m = 0; m < 16; m++) {
+			unsigned out = 0;
+			for (unsigned lane = 0; lane < 4; lane++) {
+				if (m & (1u << lane)) {
+					for (unsigned b = 0; b < 4; b++) bytes[m][out * 4 + b] = static_cast<uint8_t>(lane * 4 + b);
+					out++;
+				}
+			}
+			for (unsigned b = out * 4; b < 16; b++) bytes[m][b] = 0x80; // zero the rest
+		}
+	}
+};
+inline constexpr PackTable packTable{};
+
+// keepMatched: intersection keeps a-elements found in b, difference keeps the others.
+// The 4-int store can run up to 3 ints past the last element written (see SimdSlack).
+SIMD_TARGET("sse4.2")
+inline size_t blockCompare(const int* a, size_t na, const int* b, size_t nb, int* out, bool keepMatched) {
+	size_t i = 0, j = 0, k = 0;
+	unsigned matched = 0; // lanes of the current a-block seen in b so far
+	while (i + 4 <= na && j + 4 <= nb) {
+		__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+		__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+		__m128i eq = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+			_mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+				_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+		matched |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+		int aLast = a[i + 3], bLast = b[j + 3];
+		if (aLast <= bLast) {
+			// every b that could match this a-block has been compared: write it out
+			unsigned keep = keepMatched ? matched : (~matched & 0xF);
+			__m128i packed = _mm_shuffle_epi8(va, _mm_load_si128(reinterpret_cast<const __m128i*>(packTable.bytes[keep])));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), packed);
+			k += static_cast<size_t>(std::popcount(keep));
+			i += 4;
+			matched = 0;
+		}
+		if (bLast <= aLast) j += 4;
+	}
+	// the a-block in progress: lanes already matched are settled, the rest look further in b
+	for (size_t t = 0; t < 4 && i < na; t++, i++) {
+		bool found = (matched >> t) & 1;
+		if (!found) {
+			while (j < nb && b[j] < a[i]) j++;
+			found = j < nb && b[j] == a[i];
+		}
+		out[k] = a[i];
+		k += found == keepMatched;
+	}
+	return keepMatched ? intersectMerge(a, na, b, nb, out, i, j, k) : differenceMerge(a, na, b, nb, out, i, j, k);
+}
+#endif
+
+enum class Op { Union, Intersection, Difference };
+
+inline size_t capacity(Op op, size_t na, size_t nb) {
+	switch (op) {
+	case Op::Union: return na + nb;
+	case Op::Intersection: return std::min(na, nb) + SimdSlack;
+	default: return na + SimdSlack;
+	}
+}
+
+template <typename T>
+size_t serialOp(Op op, const T* a, size_t na, const T* b, size_t nb, T* out) {
+	if (op == Op::Union) {
+		if (na == 0 || nb == 0 || std::max(na, nb) / std::min(na, nb) < UnionGallopRatio) return unionMerge(a, na, b, nb, out);
+		return na < nb ? unionGallop(a, na, b, nb, out) : unionGallop(b, nb, a, na, out);
+	}
+	if (op == Op::Intersection) {
+		if (na == 0 || nb == 0) return 0;
+		if (na * GallopRatio <= nb) return intersectGallop(a, na, b, nb, out);
+		if (nb * GallopRatio <= na) return intersectGallop(b, nb, a, na, out);
+	} else {
+		if (na == 0) return 0;
+		if (nb == 0) { std::copy(a, a + na, out); return na; }
+		if (na * GallopRatio <= nb) return differenceGallopSmallA(a, na, b, nb, out);
+		if (nb * GallopRatio <= na) return differenceGallopSmallB(a, na, b, nb, out);
+	}
+#if SIMD_X86
+	if constexpr (std::is_same_v<T, int>) {
+		if (simd::cpuLevel() >= simd::Level::SSE42) return blockCompare(a, na, b, nb, out, op == Op::Intersection);
+	}
+#endif
+	return op == Op::Intersection ? intersectMerge(a, na, b, nb, out) : differenceMerge(a, na, b, nb, out);
+}
+
+template <typename T>
+size_t run(Op op, std::span<const T> a, std::span<const T> b, T* out, ThreadPool* pool) {
+	const size_t na = a.size(), nb = b.size();
+	const size_t pieces = pool ? std::min<size_t>({ (pool->size() + 1) * 4, (na + nb) / (size_t(1) << 16), MaxPieces }) : 1;
+	if (pieces < 2) return serialOp(op, a.data(), na, b.data(), nb, out);
+
+	// cut both inputs at the same values: piece p covers a[cutA[p], cutA[p+1]) and b[cutB[p], cutB[p+1])
+	std::span<const T> big = na >= nb ? a : b;
+	std::vector<size_t> cutA(pieces + 1), cutB(pieces + 1), count(pieces);
+	cutA[0] = cutB[0] = 0;
+	cutA[pieces] = na;
+	cutB[pieces] = nb;
+	for (size_t p = 1; p < pieces; p++) {
+		const T& splitter = big[big.size() * p / pieces];
+		cutA[p] = static_cast<size_t>(std::lower_bound(a.begin(), a.end(), splitter) - a.begin());
+		cutB[p] = static_cast<size_t>(std::lower_bound(b.begin(), b.end(), splitter) - b.begin());
+	}
+	// every piece gets room for its worst case, so pieces never write into each other
+	std::vector<size_t> offset(pieces + 1, 0);
+	for (size_t p = 0; p < pieces; p++) {
+		offset[p + 1] = offset[p] + capacity(op, cutA[p + 1] - cutA[p], cutB[p + 1] - cutB[p]);
+	}
+
+	pool->parallel_for(0, pieces, 1, [&](size_t pb, size_t pe) {
+		for (size_t p = pb; p < pe; p++) {
+			count[p] = serialOp(op, a.data() + cutA[p], cutA[p + 1] - cutA[p], b.data() + cutB[p], cutB[p + 1] - cutB[p],
+				out + offset[p]);
+		}
+	});
+
+	// pack the pieces; each one only moves left, so in order this never overwrites unread data
+	size_t total = count[0];
+	for (size_t p = 1; p < pieces; p++) {
+		if (count[p]) std::memmove(out + total, out + offset[p], count[p] * sizeof(T));
+		total += count[p];
+	}
+	return total;
+}
+
+} // namespace detail
+
+// Output buffer sizes for the ...Into() versions (worst case, including parallel mode).
+inline size_t capacityForUnion(size_t na, size_t nb) { return na + nb; }
+inline size_t capacityForIntersection(size_t na, size_t nb) { return std::min(na, nb) + SimdSlack * MaxPieces; }
+inline size_t capacityForDifference(size_t na, size_t) { return na + SimdSlack * MaxPieces; }
+
+// Caller buffer versions; return the number of elements written.
+template <typename T>
+size_t unionInto(std::span<const T> a, std::span<const T> b, T* out, ThreadPool* pool = nullptr) {
+	return detail::run(detail::Op::Union, a, b, out, pool);
+}
+template <typename T>
+size_t intersectionInto(std::span<const T> a, std::span<const T> b, T* out, ThreadPool* pool = nullptr) {
+	return detail::run(detail::Op::Intersection, a, b, out, pool);
+}
+template <typename T>
+size_t differenceInto(std::span<const T> a, std::span<const T> b, T* out, ThreadPool* pool = nullptr) {
+	return detail::run(detail::Op::Difference, a, b, out, pool);
+}
+
+template <typename T>
+std::vector<T> setUnion(std::span<const T> a, std::span<const T> b, ThreadPool* pool = nullptr) {
+	std::vector<T> out(capacityForUnion(a.size(), b.size()));
+	out.resize(unionInto(a, b, out.data(), pool));
+	return out;
+}
+template <typename T>
+std::vector<T> setIntersection(std::span<const T> a, std::span<const T> b, ThreadPool* pool = nullptr) {
+	std::vector<T> out(capacityForIntersection(a.size(), b.size()));
+	out.resize(intersectionInto(a, b, out.data(), pool));
+	return out;
+}
+template <typename T>
+std::vector<T> setDifference(std::span<const T> a, std::span<const T> b, ThreadPool* pool = nullptr) {
+	std::vector<T> out(capacityForDifference(a.size(), b.size()));
+	out.resize(differenceInto(a, b, out.data(), pool));
+	return out;
+}
+
+} // namespace setops
@@ -0,0 +1,72 @@
+// Benchmark: setops:: union / intersection / difference against std::set_union / set_intersection /
+// set_difference on sorted ID lists, across size ratios.
+// usage: set_ops_bench [big size=10000000] [reps=3]
+//
+// The big list has "big size" IDs; the small one has big/ratio IDs for ratio 1, 4, 32, 1024.
+// IDs come from a range 4x the size, so roughly a quarter of the small list is also in the big one.
+// Every result is compared with the STL result.
+#include <iostream>
+#include <vector>
+#include <random>
+#include <iterator>
+#include <cstdio>
+#include "set_ops.h"
+#include "../common/bench_util.h"
+
+std::vector<int> randomSet(size_t n, size_t universe, std::mt19937_64& rng) {
+	std::vector<int> v(n);
+	for (auto& x : v) x = static_cast<int>(rng() % universe);
+	std::sort(v.begin(), v.end());
+	v.erase(std::unique(v.begin(), v.end()), v.end());
+	return v;
+}
+
+template <typename F>
+double best(int reps, F&& fn) {
+	double t = 1e30;
+	for (int r = 0; r < reps; r++) {
+		bench::Stopwatch sw;
+		fn();
+		t = std::min(t, sw.seconds());
+	}
+	return t;
+}
+
+int main(int argc, char** argv) {
+	size_t bigN = static_cast<size_t>(bench::argOr(argc, argv, 1, 10000000));
+	int reps = static_cast<int>(bench::argOr(argc, argv, 2, 3));
+	std::mt19937_64 rng(8);
+	ThreadPool& pool = ThreadPool::instance();
+	std::printf("threads in pool: %u, times in ms\n", pool.size());
+	std::printf("%-13s %7s %10s %10s %10s %10s\n", "op", "ratio", "STL", "setops", "parallel", "speedup");
+
+	std::vector<int> big = randomSet(bigN, bigN * 4, rng);
+	for (size_t ratio : { 1, 4, 32, 1024 }) {
+		std::vector<int> small = randomSet(bigN / ratio, bigN * 4, rng);
+		std::span<const int> a(small), b(big);
+
+		auto row = [&](const char* name, auto stlOp, auto ours) {
+			std::vector<int> expect;
+			expect.reserve(a.size() + b.size());
+			double tStl = best(reps, [&] { expect.clear(); stlOp(std::back_inserter(expect)); });
+			std::vector<int> got, gotPar;
+			double tOurs = best(reps, [&] { got = ours(nullptr); });
+			double tPar = best(reps, [&] { gotPar = ours(&pool); });
+			std::printf("%-13s %7zu %10.2f %10.2f %10.2f %9.2fx%s\n", name, ratio, tStl * 1e3, tOurs * 1e3, tPar * 1e3,
+				tStl / std::min(tOurs, tPar), got == expect && gotPar == expect ? "" : "  MISMATCH");
+		};
+		row("union",
+			[&](auto out) { std::set_union(a.begin(), a.end(), b.begin(), b.end(), out); },
+			[&](ThreadPool* p) { return setops::setUnion(a, b, p); });
+		row("intersection",
+			[&](auto out) { std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), out); },
+			[&](ThreadPool* p) { return setops::setIntersection(a, b, p); });
+		row("small - big",
+			[&](auto out) { std::set_difference(a.begin(), a.end(), b.begin(), b.end(), out); },
+			[&](ThreadPool* p) { return setops::setDifference(a, b, p); });
+		row("big - small",
+			[&](auto out) { std::set_difference(b.begin(), b.end(), a.begin(), a.end(), out); },
+			[&](ThreadPool* p) { return setops::setDifference(b, a, p); });
+	}
+	return 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#include <intrin.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+/*
+Small helpers shared by the *_bench.cpp programs:
+ - Stopwatch       : wall-clock timing with steady_clock.
+ - cpuSeconds()    : user + system CPU time of the whole process (getrusage / GetProcessTimes).
+ - residentBytes() : current resident memory, used for "bytes per object" numbers.
+ - percentile()    : p50/p99/... from a vector of samples.
+ - doNotOptimize() : keeps the compiler from deleting a benchmarked result.
+ - clobberMemory() : stops the compiler from caching memory reads across loop iterations.
+*/
+namespace bench {
+
+class Stopwatch {
+private:
+	std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+public:
+	void reset() { start_ = std::chrono::steady_clock::now(); }
+	double seconds() const {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+	}
+	double nanos() const { return seconds() * 1e9; }
+};
+
+inline long long nowNanos() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline double cpuSeconds() {
+#ifdef _WIN32
+	FILETIME create, exit, kernel, user;
+	GetProcessTimes(GetCurrentProcess(), &create, &exit, &kernel, &user);
+	auto toSec = [](FILETIME ft) {
+		ULARGE_INTEGER v;
+		v.LowPart = ft.dwLowDateTime;
+		v.HighPart = ft.dwHighDateTime;
+		return v.QuadPart * 1e-7; // 100ns ticks
+	};
+	return toSec(kernel) + toSec(user);
+#else
+	rusage ru{};
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1e-6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec * 1e-6;
+#endif
+}
+
+inline size_t residentBytes() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc{};
+	GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+	return pmc.WorkingSetSize;
+#else
+	long pages = 0, resident = 0;
+	if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+		if (std::fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+		std::fclose(f);
+	}
+	return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Sorts the samples in place; p in [0, 100].
+inline double percentile(std::vector<double>& samples, double p) {
+	if (samples.empty()) return 0;
+	std::sort(samples.begin(), samples.end());
+	size_t idx = static_cast<size_t>(p / 100.0 * (samples.size() - 1) + 0.5);
+	return samples[std::min(idx, samples.size() - 1)];
+}
+
+template <typename T>
+inline void doNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static const void* volatile sink;
+	sink = &value;
+#endif
+}
+
+// Compiler barrier: values cached in registers must be re-read from memory afterwards.
+inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : : "memory");
+#elif defined(_MSC_VER)
+	_ReadWriteBarrier();
+#endif
+}
+
+// Reads argv[i] as a number, or returns the default when it is missing.
+inline long long argOr(int argc, char** argv, int i, long long def) {
+	return argc > i ? std::atoll(argv[i]) : def;
+}
+
+} // namespace bench
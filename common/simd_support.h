@@ -0,0 +1,64 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define SIMD_X86 0
+#endif
+
+// GCC/Clang compile one function for a newer ISA without -mavx2 for the whole file.
+// MSVC accepts the intrinsics anywhere, so the attribute is empty there.
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+/*
+Shared by the SIMD kernels (algorithms/, algorithms2/):
+ - SIMD_X86         : 1 when x86 intrinsics are available at all.
+ - SIMD_TARGET(isa) : put on a function that uses "avx2" / "sse4.2" intrinsics.
+ - detectLevel()    : what this CPU supports (cpuid), so one binary can pick kernels at runtime.
+   A SIMD_TARGET("avx2") function must only be called when detectLevel() said AVX2.
+*/
+namespace simd {
+
+enum class Level { Scalar, SSE42, AVX2 };
+
+inline const char* toString(Level l) {
+	switch (l) {
+	case Level::Scalar: return "scalar";
+	case Level::SSE42: return "sse4.2";
+	case Level::AVX2: return "avx2";
+	}
+	return "?";
+}
+
+inline Level detectLevel() {
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+	if (__builtin_cpu_supports("sse4.2")) return Level::SSE42;
+#elif SIMD_X86 && defined(_MSC_VER)
+	int regs[4];
+	__cpuid(regs, 1);
+	bool sse42 = (regs[2] >> 20) & 1;
+	bool osAvx = ((regs[2] >> 27) & 1) && ((_xgetbv(0) & 6) == 6); // OS saves the YMM registers
+	__cpuidex(regs, 7, 0);
+	if (osAvx && ((regs[1] >> 5) & 1)) return Level::AVX2;
+	if (sse42) return Level::SSE42;
+#endif
+	return Level::Scalar;
+}
+
+// Detected once per process.
+inline Level cpuLevel() {
+	static const Level level = detectLevel();
+	return level;
+}
+
+} // namespace simd
@@ -0,0 +1,131 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <memory>
+#include <chrono>
+
+/*
+Minimal task pool (executor):
+ - A fixed set of worker threads pull std::function<void()> jobs from one shared queue.
+ - post()   : fire-and-forget a job.
+ - submit() : run a callable and get a std::future for its result.
+ - parallel_for() : split [begin, end) into chunks, run them on the pool and wait for all.
+ - wait() : block on a future but keep running queued jobs meanwhile (safe to nest).
+ - instance() : one process-wide pool sized to the hardware, like a Singleton.
+*/
+class ThreadPool {
+private:
+	std::vector<std::thread> workers_;
+	std::deque<std::function<void()>> jobs_;
+	std::mutex mtx_;
+	std::condition_variable cv_;
+	bool stopping_ = false;
+
+	void workerLoop() {
+		while (true) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mtx_);
+				cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+				if (stopping_ && jobs_.empty()) return;
+				job = std::move(jobs_.front());
+				jobs_.pop_front();
+			}
+			job();
+		}
+	}
+
+public:
+	explicit ThreadPool(unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+		workers_.reserve(threads);
+		for (unsigned i = 0; i < threads; i++) {
+			workers_.emplace_back(&ThreadPool::workerLoop, this);
+		}
+	}
+
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			stopping_ = true;
+		}
+		cv_.notify_all();
+		for (auto& t : workers_) t.join();
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	static ThreadPool& instance() {
+		static ThreadPool pool; // created once, on first use (C++11 thread-safe)
+		return pool;
+	}
+
+	// Runs one queued job on the calling thread, if there is one.
+	bool runPendingJob() {
+		std::function<void()> job;
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			if (jobs_.empty()) return false;
+			job = std::move(jobs_.front());
+			jobs_.pop_front();
+		}
+		job();
+		return true;
+	}
+
+	// Waits for a future while helping with queued jobs, so a job may wait on jobs it submitted
+	// itself (nested parallel_for, recursive sorts) without starving the pool.
+	template <typename T>
+	T wait(std::future<T>& fut) {
+		while (fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			if (!runPendingJob()) fut.wait_for(std::chrono::microseconds(50));
+		}
+		return fut.get();
+	}
+
+	unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+	void post(std::function<void()> job) {
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			jobs_.push_back(std::move(job));
+		}
+		cv_.notify_one();
+	}
+
+	template <typename F>
+	auto submit(F&& f) -> std::future<std::invoke_result_t<F>> {
+		using R = std::invoke_result_t<F>;
+		// std::function needs a copyable callable, so the packaged_task lives in a shared_ptr
+		auto job = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+		std::future<R> fut = job->get_future();
+		post([job] { (*job)(); });
+		return fut;
+	}
+
+	// Calls fn(chunkBegin, chunkEnd) for chunks of at least 'grain' indices and blocks until all finish.
+	// The calling thread runs the last chunk itself, so this also works on a pool of size 1.
+	template <typename F>
+	void parallel_for(size_t begin, size_t end, size_t grain, F&& fn) {
+		if (begin >= end) return;
+		size_t n = end - begin;
+		size_t chunks = std::min<size_t>(size() + 1, std::max<size_t>(1, n / std::max<size_t>(1, grain)));
+		size_t step = (n + chunks - 1) / chunks;
+		std::vector<std::future<void>> pending;
+		pending.reserve(chunks);
+		size_t lo = begin;
+		for (; lo + step < end; lo += step) {
+			size_t hi = lo + step;
+			pending.push_back(submit([&fn, lo, hi] { fn(lo, hi); }));
+		}
+		fn(lo, end);
+		for (auto& f : pending) wait(f);
+	}
+};
@@ -0,0 +1,244 @@
+#pragma once
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <optional>
+#include <utility>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include "../common/thread_pool.h"
+#include "../sync_primitives/adaptive_waiter.h"
+
+/*
+co_await-able versions of std::promise/std::future and of a message channel.
+ - A std::future::get() parks a whole thread; co_await on an AsyncFuture only parks the coroutine
+   frame (a few hundred bytes) and gives the worker thread back to the pool.
+ - When the value arrives, the waiting coroutine is posted back onto the executor (ThreadPool),
+   so it always resumes on a pool worker, never inside set_value()/send().
+*/
+
+namespace detail {
+
+template <typename T>
+struct AsyncState {
+	std::mutex mtx;
+	std::condition_variable cv; // only used by blocking get()
+	std::atomic<bool> ready{ false };
+	std::atomic<int> parked{ 0 }; // threads sleeping in get(); skip notify when 0
+	std::optional<T> value;
+	std::exception_ptr error;
+	std::coroutine_handle<> waiter;
+	ThreadPool* exec;
+
+	explicit AsyncState(ThreadPool& e) : exec(&e) {}
+
+	template <typename Store>
+	void complete(Store&& store) {
+		std::coroutine_handle<> h;
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			if (ready.load(std::memory_order_relaxed)) throw std::future_error(std::future_errc::promise_already_satisfied);
+			store();
+			ready.store(true, std::memory_order_release);
+			h = std::exchange(waiter, nullptr);
+		}
+		if (parked.load(std::memory_order_seq_cst) > 0) {
+			std::lock_guard<std::mutex> lock(mtx); // pairs with the check inside the waiter's cv.wait
+			cv.notify_all();
+		}
+		if (h) exec->post([h] { h.resume(); });
+	}
+
+	T take() {
+		if (error) std::rethrow_exception(error);
+		return std::move(*value);
+	}
+};
+
+} // namespace detail
+
+template <typename T>
+class AsyncFuture {
+private:
+	std::shared_ptr<detail::AsyncState<T>> state_;
+
+public:
+	explicit AsyncFuture(std::shared_ptr<detail::AsyncState<T>> st) : state_(std::move(st)) {}
+
+	bool is_ready() const { return state_->ready.load(std::memory_order_acquire); }
+
+	// co_await fut : suspend until the promise is fulfilled, then resume on the executor
+	auto operator co_await() {
+		struct Awaiter {
+			detail::AsyncState<T>& st;
+			bool await_ready() const noexcept { return st.ready.load(std::memory_order_acquire); }
+			bool await_suspend(std::coroutine_handle<> h) {
+				std::lock_guard<std::mutex> lock(st.mtx);
+				if (st.ready.load(std::memory_order_relaxed)) return false; // raced with set_value, don't suspend
+				st.waiter = h;
+				return true;
+			}
+			T await_resume() { return st.take(); }
+		};
+		return Awaiter{ *state_ };
+	}
+
+	// Blocking wait for code that is not a coroutine (e.g. main()): spin, yield, then park.
+	T get() {
+		detail::AsyncState<T>& st = *state_;
+		waiter().wait(
+			[&] { return st.ready.load(std::memory_order_acquire); },
+			[&] {
+				std::unique_lock<std::mutex> lock(st.mtx);
+				st.parked.fetch_add(1, std::memory_order_seq_cst);
+				st.cv.wait(lock, [&] { return st.ready.load(std::memory_order_relaxed); });
+				st.parked.fetch_sub(1, std::memory_order_relaxed);
+			});
+		return st.take();
+	}
+
+	// One learned spin budget shared by all futures of this type.
+	static AdaptiveWaiter& waiter() {
+		static AdaptiveWaiter w;
+		return w;
+	}
+};
+
+template <typename T>
+class AsyncPromise {
+private:
+	std::shared_ptr<detail::AsyncState<T>> state_;
+
+public:
+	explicit AsyncPromise(ThreadPool& exec = ThreadPool::instance())
+		: state_(std::make_shared<detail::AsyncState<T>>(exec)) {}
+
+	AsyncFuture<T> get_future() { return AsyncFuture<T>(state_); }
+
+	template <typename U>
+	void set_value(U&& v) {
+		state_->complete([&] { state_->value.emplace(std::forward<U>(v)); });
+	}
+
+	void set_exception(std::exception_ptr e) {
+		state_->complete([&] { state_->error = e; });
+	}
+};
+
+/*
+Channel<T>: unbounded multi-producer / multi-consumer queue.
+ - send() never blocks.
+ - co_await ch.receive() returns the next item, or std::nullopt once the channel is closed and empty.
+ - A sender that finds a suspended receiver hands the item straight to it and posts it to the executor.
+ - receive_blocking() is for plain threads; it spins/yields/parks through an AdaptiveWaiter.
+*/
+template <typename T>
+class Channel {
+private:
+	struct ReceiveAwaiter;
+
+	std::mutex mtx_;
+	std::deque<T> items_;
+	std::deque<ReceiveAwaiter*> receivers_;
+	bool closed_ = false;
+	ThreadPool& exec_;
+	std::condition_variable cv_;          // blocking receivers park here
+	int parkedBlocking_ = 0;
+	std::atomic<size_t> available_{ 0 };  // items_.size(), readable without the lock
+	std::atomic<bool> closedFlag_{ false };
+	AdaptiveWaiter waiter_;
+
+	struct ReceiveAwaiter {
+		Channel& ch;
+		std::optional<T> slot;
+		std::coroutine_handle<> h;
+
+		bool await_ready() noexcept { return false; }
+		bool await_suspend(std::coroutine_handle<> awaiting) {
+			std::lock_guard<std::mutex> lock(ch.mtx_);
+			if (!ch.items_.empty()) {
+				slot.emplace(std::move(ch.items_.front()));
+				ch.items_.pop_front();
+				ch.available_.store(ch.items_.size(), std::memory_order_relaxed);
+				return false;
+			}
+			if (ch.closed_) return false;
+			h = awaiting;
+			ch.receivers_.push_back(this);
+			return true;
+		}
+		std::optional<T> await_resume() { return std::move(slot); }
+	};
+
+public:
+	explicit Channel(ThreadPool& exec = ThreadPool::instance()) : exec_(exec) {}
+
+	Channel(const Channel&) = delete;
+	Channel& operator=(const Channel&) = delete;
+
+	void send(T item) {
+		ReceiveAwaiter* r = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			if (closed_) throw std::logic_error("send on closed channel");
+			if (receivers_.empty()) {
+				items_.push_back(std::move(item));
+				available_.store(items_.size(), std::memory_order_release);
+				if (parkedBlocking_ > 0) cv_.notify_one();
+				return;
+			}
+			r = receivers_.front();
+			receivers_.pop_front();
+			r->slot.emplace(std::move(item));
+		}
+		auto h = r->h;
+		exec_.post([h] { h.resume(); });
+	}
+
+	ReceiveAwaiter receive() { return ReceiveAwaiter{ *this, std::nullopt, nullptr }; }
+
+	// Same as co_await receive(), for threads that are not coroutines.
+	std::optional<T> receive_blocking() {
+		while (true) {
+			waiter_.wait(
+				[&] { return available_.load(std::memory_order_acquire) > 0 || closedFlag_.load(std::memory_order_acquire); },
+				[&] {
+					std::unique_lock<std::mutex> lock(mtx_);
+					parkedBlocking_++;
+					cv_.wait(lock, [&] { return !items_.empty() || closed_; });
+					parkedBlocking_--;
+				});
+			std::lock_guard<std::mutex> lock(mtx_);
+			if (!items_.empty()) {
+				std::optional<T> item(std::move(items_.front()));
+				items_.pop_front();
+				available_.store(items_.size(), std::memory_order_relaxed);
+				return item;
+			}
+			if (closed_) return std::nullopt;
+			// another receiver took it first; wait again
+		}
+	}
+
+	const AdaptiveWaiter& blockingWaiter() const { return waiter_; }
+
+	// Wakes every waiting receiver with std::nullopt; queued items can still be drained.
+	void close() {
+		std::deque<ReceiveAwaiter*> waiting;
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			closed_ = true;
+			closedFlag_.store(true, std::memory_order_release);
+			waiting.swap(receivers_);
+		}
+		cv_.notify_all();
+		for (auto* r : waiting) {
+			auto h = r->h;
+			exec_.post([h] { h.resume(); });
+		}
+	}
+};
@@ -0,0 +1,160 @@
+// Benchmark: many suspended coroutines vs. many blocked threads.
+// usage: coroutine_bench [coroutines=1000000] [threads=10000] [pool threads=hw]
+//
+// Spawning 1M std::threads is not possible on most machines (default limits are ~30k threads
+// and each reserves an 8MB stack), so the thread side runs a smaller count and is reported per thread.
+#include <iostream>
+#include <thread>
+#include <future>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include "task.h"
+#include "awaitables.h"
+#include "../common/bench_util.h"
+
+std::atomic<long long> g_suspending{ 0 };
+std::atomic<long long> g_resumed{ 0 };
+
+task<void> waitOne(AsyncFuture<int> fut, long long* resumedAt)
+{
+	g_suspending.fetch_add(1, std::memory_order_relaxed);
+	int v = co_await fut;
+	*resumedAt = bench::nowNanos();
+	bench::doNotOptimize(v);
+	g_resumed.fetch_add(1, std::memory_order_release);
+}
+
+void benchCoroutines(ThreadPool& pool, size_t n) {
+	std::vector<AsyncPromise<int>> promises;
+	std::vector<long long> resumedAt(n, 0);
+	promises.reserve(n);
+	for (size_t i = 0; i < n; i++) promises.emplace_back(pool);
+
+	size_t rssBefore = bench::residentBytes();
+	bench::Stopwatch sw;
+	for (size_t i = 0; i < n; i++) {
+		spawn(pool, waitOne(promises[i].get_future(), &resumedAt[i]));
+	}
+	// wait until every coroutine has reached its co_await
+	while (g_suspending.load(std::memory_order_relaxed) < static_cast<long long>(n)) std::this_thread::yield();
+	double suspendSec = sw.seconds();
+	size_t rssAfter = bench::residentBytes();
+
+	// resume them all; latency is measured from set_value() to the first instruction after co_await
+	std::vector<long long> setAt(n);
+	sw.reset();
+	for (size_t i = 0; i < n; i++) {
+		setAt[i] = bench::nowNanos();
+		promises[i].set_value(static_cast<int>(i));
+	}
+	while (g_resumed.load(std::memory_order_acquire) < static_cast<long long>(n)) std::this_thread::yield();
+	double resumeSec = sw.seconds();
+
+	std::vector<double> lat;
+	lat.reserve(n);
+	for (size_t i = 0; i < n; i++) lat.push_back(static_cast<double>(resumedAt[i] - setAt[i]));
+
+	printf("coroutines: %zu\n", n);
+	printf("  spawn+suspend      : %.3f s (%.0f ns each)\n", suspendSec, suspendSec * 1e9 / n);
+	printf("  memory per waiter  : %.0f bytes (coroutine frames, RSS delta)\n",
+		static_cast<double>(rssAfter - rssBefore) / n);
+	printf("  resume all         : %.3f s (%.1f M resumes/s)\n", resumeSec, n / resumeSec / 1e6);
+	printf("  mass-wake ns       : p50 %.0f  p99 %.0f  p99.9 %.0f\n",
+		bench::percentile(lat, 50), bench::percentile(lat, 99), bench::percentile(lat, 99.9));
+}
+
+// One waiter at a time, so the number is the pure set_value() -> resumed cost without queueing.
+void isolatedLatency(ThreadPool& pool, int samples) {
+	std::vector<double> coro, thr;
+	long long resumedAt = 0;
+	for (int i = 0; i < samples; i++) {
+		AsyncPromise<int> p(pool);
+		long long before = g_resumed.load();
+		long long target = g_suspending.load() + 1;
+		spawn(pool, waitOne(p.get_future(), &resumedAt));
+		while (g_suspending.load(std::memory_order_relaxed) < target) std::this_thread::yield();
+		std::this_thread::sleep_for(std::chrono::microseconds(20));
+		long long setAt = bench::nowNanos();
+		p.set_value(i);
+		while (g_resumed.load(std::memory_order_acquire) == before) std::this_thread::yield();
+		coro.push_back(static_cast<double>(resumedAt - setAt));
+	}
+	for (int i = 0; i < samples; i++) {
+		std::promise<int> p;
+		std::future<int> f = p.get_future();
+		std::atomic<bool> parked{ false };
+		long long wokeAt = 0;
+		std::thread t([&] {
+			parked = true;
+			bench::doNotOptimize(f.get());
+			wokeAt = bench::nowNanos();
+		});
+		while (!parked) std::this_thread::yield();
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+		long long setAt = bench::nowNanos();
+		p.set_value(i);
+		t.join();
+		thr.push_back(static_cast<double>(wokeAt - setAt));
+	}
+	printf("isolated wake latency (%d samples, ns)\n", samples);
+	printf("  coroutine resume   : p50 %.0f  p99 %.0f\n", bench::percentile(coro, 50), bench::percentile(coro, 99));
+	printf("  blocked thread     : p50 %.0f  p99 %.0f\n", bench::percentile(thr, 50), bench::percentile(thr, 99));
+}
+
+void benchThreads(size_t n) {
+	std::vector<std::promise<int>> promises(n);
+	std::vector<long long> resumedAt(n, 0);
+	std::vector<std::thread> threads;
+	std::atomic<size_t> waiting{ 0 };
+	threads.reserve(n);
+
+	size_t rssBefore = bench::residentBytes();
+	bench::Stopwatch sw;
+	for (size_t i = 0; i < n; i++) {
+		threads.emplace_back([&, i] {
+			std::future<int> fut = promises[i].get_future();
+			waiting.fetch_add(1);
+			int v = fut.get();
+			resumedAt[i] = bench::nowNanos();
+			bench::doNotOptimize(v);
+		});
+	}
+	while (waiting.load() < n) std::this_thread::yield();
+	std::this_thread::sleep_for(std::chrono::milliseconds(50)); // let them park in get()
+	double spawnSec = sw.seconds();
+	size_t rssAfter = bench::residentBytes();
+
+	std::vector<long long> setAt(n);
+	sw.reset();
+	for (size_t i = 0; i < n; i++) {
+		setAt[i] = bench::nowNanos();
+		promises[i].set_value(static_cast<int>(i));
+	}
+	for (auto& t : threads) t.join();
+	double wakeSec = sw.seconds();
+
+	std::vector<double> lat;
+	lat.reserve(n);
+	for (size_t i = 0; i < n; i++) lat.push_back(static_cast<double>(resumedAt[i] - setAt[i]));
+
+	printf("blocked threads: %zu\n", n);
+	printf("  spawn+block        : %.3f s (%.0f ns each)\n", spawnSec, spawnSec * 1e9 / n);
+	printf("  memory per waiter  : %.0f bytes resident (+%zu KB stack reserved each)\n",
+		static_cast<double>(rssAfter - rssBefore) / n, static_cast<size_t>(8192));
+	printf("  wake all + join    : %.3f s (%.0f wakes/s)\n", wakeSec, n / wakeSec);
+	printf("  mass-wake ns       : p50 %.0f  p99 %.0f  p99.9 %.0f\n",
+		bench::percentile(lat, 50), bench::percentile(lat, 99), bench::percentile(lat, 99.9));
+}
+
+int main(int argc, char** argv) {
+	size_t coroutines = static_cast<size_t>(bench::argOr(argc, argv, 1, 1000000));
+	size_t threads = static_cast<size_t>(bench::argOr(argc, argv, 2, 10000));
+	unsigned poolSize = static_cast<unsigned>(bench::argOr(argc, argv, 3, std::max(1u, std::thread::hardware_concurrency())));
+
+	ThreadPool pool(poolSize);
+	benchCoroutines(pool, coroutines);
+	benchThreads(threads);
+	isolatedLatency(pool, 2000);
+	return 0;
+}
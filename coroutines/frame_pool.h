@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include <vector>
+
+/*
+Pooled allocator for coroutine frames.
+ - Every coroutine call allocates a frame with operator new; with millions of short-lived
+   coroutines that is millions of malloc/free calls.
+ - Frames are rounded up to a 64-byte size class and recycled through a per-thread free list,
+   so the common case is a pointer pop/push with no lock.
+ - A thread that runs out grabs a batch from a shared list (or carves a new chunk);
+   a thread that exits hands its list back to the shared one.
+ - Frames larger than MaxPooled go straight to ::operator new.
+*/
+class FramePool {
+public:
+	static constexpr size_t Granularity = 64;
+	static constexpr size_t MaxPooled = 2048;
+	static constexpr size_t Classes = MaxPooled / Granularity;
+	static constexpr size_t BlocksPerChunk = 64;
+
+	static void* allocate(size_t bytes) {
+		if (bytes > MaxPooled) return ::operator new(bytes);
+		size_t cls = classOf(bytes);
+		ThreadCache& cache = threadCache();
+		if (!cache.heads[cls]) refill(cache, cls);
+		FreeBlock* block = cache.heads[cls];
+		cache.heads[cls] = block->next;
+		return block;
+	}
+
+	static void deallocate(void* ptr, size_t bytes) noexcept {
+		if (bytes > MaxPooled) {
+			::operator delete(ptr);
+			return;
+		}
+		size_t cls = classOf(bytes);
+		ThreadCache& cache = threadCache();
+		FreeBlock* block = static_cast<FreeBlock*>(ptr);
+		block->next = cache.heads[cls];
+		cache.heads[cls] = block;
+	}
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct Shared {
+		std::mutex mtx;
+		FreeBlock* heads[Classes] = {};
+		std::vector<void*> chunks; // kept for the whole process lifetime
+	};
+
+	struct ThreadCache {
+		FreeBlock* heads[Classes] = {};
+		~ThreadCache() {
+			// give our blocks back so other threads can reuse them
+			Shared& sh = shared();
+			std::lock_guard<std::mutex> lock(sh.mtx);
+			for (size_t cls = 0; cls < Classes; cls++) {
+				while (FreeBlock* b = heads[cls]) {
+					heads[cls] = b->next;
+					b->next = sh.heads[cls];
+					sh.heads[cls] = b;
+				}
+			}
+		}
+	};
+
+	static size_t classOf(size_t bytes) {
+		return bytes == 0 ? 0 : (bytes - 1) / Granularity;
+	}
+
+	static Shared& shared() {
+		static Shared* sh = new Shared; // never destroyed: thread caches may outlive statics
+		return *sh;
+	}
+
+	static ThreadCache& threadCache() {
+		thread_local ThreadCache cache;
+		return cache;
+	}
+
+	static void refill(ThreadCache& cache, size_t cls) {
+		Shared& sh = shared();
+		size_t blockSize = (cls + 1) * Granularity;
+		std::lock_guard<std::mutex> lock(sh.mtx);
+		// take up to one chunk's worth of recycled blocks first
+		for (size_t i = 0; i < BlocksPerChunk && sh.heads[cls]; i++) {
+			FreeBlock* b = sh.heads[cls];
+			sh.heads[cls] = b->next;
+			b->next = cache.heads[cls];
+			cache.heads[cls] = b;
+		}
+		if (cache.heads[cls]) return;
+
+		char* chunk = static_cast<char*>(::operator new(blockSize * BlocksPerChunk));
+		sh.chunks.push_back(chunk);
+		for (size_t i = 0; i < BlocksPerChunk; i++) {
+			FreeBlock* b = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+			b->next = cache.heads[cls];
+			cache.heads[cls] = b;
+		}
+	}
+};
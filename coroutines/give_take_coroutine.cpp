@@ -0,0 +1,66 @@
+// give()/take() from future_and_promise/futurePromise2.cpp, rewritten with coroutines.
+// The original take() blocks its thread inside fut.get() for the whole 2 seconds;
+// here take() is suspended instead and no thread is held while it waits.
+#include <iostream>
+#include <thread>
+#include "task.h"
+#include "awaitables.h"
+using namespace std::literals;
+
+// example 1: give/take with an awaitable promise/future pair
+task<void> give(AsyncPromise<double>& p)
+{
+	std::cout << "give calculating value on thread " << std::this_thread::get_id() << "\n";
+	double piVal = 22.0 / 7;
+	std::this_thread::sleep_for(2s); // simulated work, still occupies this worker
+
+	std::cout << "give sets the value! \n";
+	p.set_value(piVal);
+	co_return;
+}
+
+task<double> take(ThreadPool& pool)
+{
+	AsyncPromise<double> prom(pool);
+	AsyncFuture<double> fut = prom.get_future();
+	spawn(pool, give(prom));
+
+	std::cout << "take suspended waiting for the value.. \n";
+	double val = co_await fut; // no thread is blocked here
+	std::cout << "take resumed on thread " << std::this_thread::get_id() << ", value: " << val << "\n";
+	co_return val;
+}
+
+// example 2: producer/consumer over a channel instead of a callback chain
+task<void> producer(Channel<int>& ch)
+{
+	for (int i = 1; i <= 5; i++) {
+		ch.send(i * 10);
+	}
+	ch.close();
+	co_return;
+}
+
+task<int> consumer(Channel<int>& ch)
+{
+	int total = 0;
+	while (auto item = co_await ch.receive()) {
+		std::cout << "consumer got " << *item << "\n";
+		total += *item;
+	}
+	co_return total;
+}
+
+int main() {
+	ThreadPool pool(2);
+
+	double val = sync_wait(take(pool));
+	std::cout << "main got: " << val << "\n\n";
+
+	Channel<int> ch(pool);
+	spawn(pool, producer(ch));
+	int total = sync_wait(consumer(ch));
+	std::cout << "sum received: " << total << "\n";
+
+	return 0;
+}
@@ -0,0 +1,218 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include "frame_pool.h"
+#include "../common/thread_pool.h"
+#include "../sync_primitives/adaptive_waiter.h"
+
+/*
+task<T>: a lazy C++20 coroutine that produces one T.
+ - Nothing runs until someone co_awaits the task (or hands it to spawn()/sync_wait()).
+ - When the body finishes, the awaiting coroutine is resumed directly (symmetric transfer),
+   so a chain of co_awaits never grows the thread's stack.
+ - Frames come from FramePool instead of the global heap.
+ - co_await schedule(pool) moves the rest of the coroutine onto a ThreadPool worker.
+*/
+
+// Shared by every promise type: frames are allocated from the pool.
+struct PooledFrame {
+	static void* operator new(size_t bytes) { return FramePool::allocate(bytes); }
+	static void operator delete(void* ptr, size_t bytes) noexcept { FramePool::deallocate(ptr, bytes); }
+};
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+struct TaskPromiseBase : PooledFrame {
+	std::coroutine_handle<> continuation_ = std::noop_coroutine();
+	std::exception_ptr error_;
+
+	std::suspend_always initial_suspend() noexcept { return {}; }
+
+	struct FinalAwaiter {
+		bool await_ready() noexcept { return false; }
+		template <typename P>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+			return h.promise().continuation_;
+		}
+		void await_resume() noexcept {}
+	};
+	FinalAwaiter final_suspend() noexcept { return {}; }
+
+	void unhandled_exception() { error_ = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+	std::optional<T> value_;
+
+	task<T> get_return_object() noexcept;
+	template <typename U>
+	void return_value(U&& v) { value_.emplace(std::forward<U>(v)); }
+
+	T result() {
+		if (error_) std::rethrow_exception(error_);
+		return std::move(*value_);
+	}
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+	task<void> get_return_object() noexcept;
+	void return_void() noexcept {}
+
+	void result() {
+		if (error_) std::rethrow_exception(error_);
+	}
+};
+
+} // namespace detail
+
+template <typename T>
+class task {
+public:
+	using promise_type = detail::TaskPromise<T>;
+	using handle_type = std::coroutine_handle<promise_type>;
+
+	explicit task(handle_type h) noexcept : handle_(h) {}
+	task(task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+	task& operator=(task&& other) noexcept {
+		if (this != &other) {
+			if (handle_) handle_.destroy();
+			handle_ = std::exchange(other.handle_, {});
+		}
+		return *this;
+	}
+	task(const task&) = delete;
+	task& operator=(const task&) = delete;
+	~task() {
+		if (handle_) handle_.destroy();
+	}
+
+	// co_await someTask : start it and resume us when it is done
+	auto operator co_await() && noexcept {
+		struct Awaiter {
+			handle_type h;
+			bool await_ready() noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+				h.promise().continuation_ = awaiting;
+				return h;
+			}
+			T await_resume() { return h.promise().result(); }
+		};
+		return Awaiter{ handle_ };
+	}
+
+private:
+	handle_type handle_;
+};
+
+namespace detail {
+
+template <typename T>
+task<T> TaskPromise<T>::get_return_object() noexcept {
+	return task<T>{ std::coroutine_handle<TaskPromise<T>>::from_promise(*this) };
+}
+
+inline task<void> TaskPromise<void>::get_return_object() noexcept {
+	return task<void>{ std::coroutine_handle<TaskPromise<void>>::from_promise(*this) };
+}
+
+// Fire-and-forget coroutine: starts immediately and frees its own frame at the end.
+struct DetachedTask {
+	struct promise_type : PooledFrame {
+		DetachedTask get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+} // namespace detail
+
+// co_await schedule(pool) : continue on one of the pool's worker threads
+inline auto schedule(ThreadPool& pool) {
+	struct Awaiter {
+		ThreadPool& pool;
+		bool await_ready() noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> h) {
+			pool.post([h] { h.resume(); });
+		}
+		void await_resume() noexcept {}
+	};
+	return Awaiter{ pool };
+}
+
+// Runs the task on the pool without waiting for it. Exceptions escaping the task terminate.
+namespace detail {
+template <typename T>
+DetachedTask spawnRunner(ThreadPool& pool, task<T> t) {
+	co_await schedule(pool);
+	co_await std::move(t);
+}
+} // namespace detail
+
+template <typename T>
+void spawn(ThreadPool& pool, task<T> t) {
+	detail::spawnRunner(pool, std::move(t));
+}
+
+namespace detail {
+
+template <typename T>
+struct SyncWaitState {
+	std::mutex mtx;
+	std::condition_variable cv;
+	std::atomic<bool> done{ false };
+	std::exception_ptr error;
+	std::optional<std::conditional_t<std::is_void_v<T>, char, T>> value;
+};
+
+// The state is a parameter (not a lambda capture) so it lives in the coroutine frame.
+template <typename T>
+DetachedTask syncWaitRunner(task<T> t, SyncWaitState<T>& st) {
+	try {
+		if constexpr (std::is_void_v<T>) co_await std::move(t);
+		else st.value.emplace(co_await std::move(t));
+	}
+	catch (...) {
+		st.error = std::current_exception();
+	}
+	std::lock_guard<std::mutex> lock(st.mtx);
+	st.done.store(true, std::memory_order_release);
+	st.cv.notify_one();
+}
+
+inline AdaptiveWaiter& syncWaiter() {
+	static AdaptiveWaiter w;
+	return w;
+}
+
+} // namespace detail
+
+// Blocks the calling (non-pool) thread until the task finishes and returns its result.
+// Short tasks are caught while spinning; long ones park the thread.
+template <typename T>
+T sync_wait(task<T> t) {
+	detail::SyncWaitState<T> st;
+	detail::syncWaitRunner(std::move(t), st);
+
+	detail::syncWaiter().wait(
+		[&] { return st.done.load(std::memory_order_acquire); },
+		[&] {
+			std::unique_lock<std::mutex> lock(st.mtx);
+			st.cv.wait(lock, [&] { return st.done.load(std::memory_order_relaxed); });
+		});
+	// the runner may still be inside notify_one(); wait for it to drop the lock before st dies
+	std::lock_guard<std::mutex> lock(st.mtx);
+	if (st.error) std::rethrow_exception(st.error);
+	if constexpr (!std::is_void_v<T>) return std::move(*st.value);
+}
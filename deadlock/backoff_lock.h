@@ -0,0 +1,100 @@
+#pragma once
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <span>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+#include "../sync_primitives/adaptive_waiter.h"
+
+/*
+Multi-mutex acquisition with randomized exponential backoff.
+ - std::try_lock(m1, m2) gives up on the first failure (try_lock.cpp prints "unable to lock mutex").
+ - std::lock(m1, m2) never gives up, and under heavy contention threads can keep taking and
+   releasing locks in lockstep (livelock-like spinning).
+ - lockWithBackoff() tries all mutexes; if one is busy it releases the rest and waits a random
+   time in [0, delay), doubling delay up to maxDelay. Random waits break the lockstep.
+ - It gives up after maxRetries failed rounds or at the deadline, whichever comes first.
+ - Return value follows std::try_lock: -1 when everything is locked, otherwise the index of the
+   mutex that failed in the last attempt (nothing is held in that case).
+*/
+struct BackoffPolicy {
+	std::chrono::nanoseconds minDelay{ 100 };
+	std::chrono::nanoseconds maxDelay{ 100000 };
+	int maxRetries = -1; // -1 = unbounded
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+class Backoff {
+public:
+	explicit Backoff(const BackoffPolicy& p) : policy_(p), delayNs_(p.minDelay.count()) {}
+
+	// Waits before the next attempt. Returns false when the policy says to give up.
+	bool wait() {
+		if (policy_.maxRetries >= 0 && retries_ >= policy_.maxRetries) return false;
+		retries_++;
+		auto now = std::chrono::steady_clock::now();
+		if (now >= policy_.deadline) return false;
+
+		long long pause = static_cast<long long>(nextRandom() % static_cast<uint64_t>(delayNs_ + 1));
+		auto until = now + std::chrono::nanoseconds(pause);
+		if (until > policy_.deadline) until = policy_.deadline;
+		if (pause < 2000) {
+			// shorter than a context switch: spin
+			while (std::chrono::steady_clock::now() < until) cpuRelax();
+		}
+		else {
+			std::this_thread::sleep_until(until);
+		}
+		delayNs_ = std::min<long long>(delayNs_ * 2, policy_.maxDelay.count());
+		return true;
+	}
+
+	int retries() const { return retries_; }
+
+private:
+	const BackoffPolicy& policy_;
+	long long delayNs_;
+	int retries_ = 0;
+
+	static uint64_t nextRandom() {
+		// xorshift64*, one state per thread so threads back off independently
+		thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ std::hash<std::thread::id>{}(std::this_thread::get_id());
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 0x2545F4914F6CDD1Dull;
+	}
+};
+
+// Fixed set of (possibly different) lockable types, like std::try_lock.
+template <typename... Lockables>
+int lockWithBackoff(const BackoffPolicy& policy, Lockables&... locks) {
+	Backoff backoff(policy);
+	while (true) {
+		int failed = std::try_lock(locks...);
+		if (failed == -1) return -1;
+		if (!backoff.wait()) return failed;
+	}
+}
+
+// Runtime-sized set of mutexes of one type.
+template <typename Lockable>
+int lockWithBackoff(const BackoffPolicy& policy, std::span<Lockable* const> locks) {
+	Backoff backoff(policy);
+	while (true) {
+		size_t i = 0;
+		for (; i < locks.size(); i++) {
+			if (!locks[i]->try_lock()) break;
+		}
+		if (i == locks.size()) return -1;
+		for (size_t j = i; j-- > 0;) locks[j]->unlock();
+		if (!backoff.wait()) return static_cast<int>(i);
+	}
+}
+
+template <typename Lockable>
+void unlockAll(std::span<Lockable* const> locks) {
+	for (size_t j = locks.size(); j-- > 0;) locks[j]->unlock();
+}
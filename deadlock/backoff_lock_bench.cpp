@@ -0,0 +1,94 @@
+// Benchmark: locking M shared mutexes at once, std::scoped_lock vs. lockWithBackoff().
+// usage: backoff_lock_bench [milliseconds per run=200] [max threads=32]
+//
+// Every thread locks the same M mutexes but in its own shuffled order (the case deadlock.cpp
+// gets wrong and std::scoped_lock / std::lock exist for). Reported per run:
+//   ops/s    : completed critical sections per second, all threads
+//   fairness : Jain's index of per-thread counts (1.0 = perfectly even, 1/T = one thread did all)
+//   min/max  : slowest thread's count / fastest thread's count
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <tuple>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include "backoff_lock.h"
+#include "../common/bench_util.h"
+
+struct Result {
+	double opsPerSec, jain, minMax;
+};
+
+Result summarize(const std::vector<long long>& counts, double seconds) {
+	double sum = 0, sumSq = 0;
+	for (long long c : counts) {
+		sum += c;
+		sumSq += static_cast<double>(c) * c;
+	}
+	auto [mn, mx] = std::minmax_element(counts.begin(), counts.end());
+	return { sum / seconds, sumSq > 0 ? sum * sum / (counts.size() * sumSq) : 0, *mx ? double(*mn) / *mx : 0 };
+}
+
+template <size_t M, typename LockAll>
+Result run(std::array<std::mutex, M>& mtxs, size_t threads, int ms, LockAll lockAll) {
+	std::atomic<bool> stop{ false };
+	std::vector<long long> counts(threads, 0);
+	long long shared = 0;
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			std::array<std::mutex*, M> order;
+			for (size_t i = 0; i < M; i++) order[i] = &mtxs[i];
+			std::shuffle(order.begin(), order.end(), std::mt19937(static_cast<unsigned>(t)));
+			while (!stop.load(std::memory_order_relaxed)) {
+				lockAll(order, [&] { shared++; });
+				counts[t]++;
+			}
+		});
+	}
+	bench::Stopwatch sw;
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+	stop = true;
+	for (auto& w : workers) w.join();
+	return summarize(counts, sw.seconds());
+}
+
+template <size_t M>
+void benchM(int ms, size_t maxThreads) {
+	std::array<std::mutex, M> mtxs;
+	BackoffPolicy policy;
+	for (size_t threads = 2; threads <= maxThreads; threads *= 2) {
+		Result a = run<M>(mtxs, threads, ms, [](std::array<std::mutex*, M>& order, auto&& body) {
+			std::apply([&](auto*... m) {
+				std::scoped_lock lock(*m...);
+				body();
+			}, order);
+		});
+		Result b = run<M>(mtxs, threads, ms, [&policy](std::array<std::mutex*, M>& order, auto&& body) {
+			std::span<std::mutex* const> locks(order);
+			lockWithBackoff(policy, locks);
+			body();
+			unlockAll(locks);
+		});
+		printf("%3zu %4zu | %12.0f %6.3f %6.3f | %12.0f %6.3f %6.3f\n", M, threads,
+			a.opsPerSec, a.jain, a.minMax, b.opsPerSec, b.jain, b.minMax);
+	}
+}
+
+int main(int argc, char** argv) {
+	int ms = static_cast<int>(bench::argOr(argc, argv, 1, 200));
+	size_t maxThreads = static_cast<size_t>(bench::argOr(argc, argv, 2, 32));
+
+	printf("%3s %4s | %12s %6s %6s | %12s %6s %6s\n", "M", "T", "scoped ops/s", "jain", "mn/mx",
+		"backoff op/s", "jain", "mn/mx");
+	benchM<2>(ms, maxThreads);
+	benchM<3>(ms, maxThreads);
+	benchM<4>(ms, maxThreads);
+	benchM<6>(ms, maxThreads);
+	benchM<8>(ms, maxThreads);
+	return 0;
+}
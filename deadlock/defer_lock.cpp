@@ -45,6 +45,8 @@
 Real-World Use of std::lock + std::defer_lock:
 Useful when a function needs to lock multiple resources, but you want to control exactly when locking happens and avoid deadlocks.
 For example: multi-resource banking transactions, parallel logging, or resource merging.
+With thousands of accounts, one mutex per account gets expensive: see striped_lock_manager.h,
+which hashes accounts onto a fixed set of stripes and locks them in sorted order (same deadlock-free idea).
 */
 
 
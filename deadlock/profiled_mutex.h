@@ -0,0 +1,265 @@
+#pragma once
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <ostream>
+#include <cstdio>
+#include <cstdint>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define LOCKPROF_RDTSC 1
+#elif !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define LOCKPROF_RDTSC 1
+#else
+#define LOCKPROF_RDTSC 0 // ARM64 etc.: steady_clock
+#endif
+
+/*
+ProfiledMutex: a std::mutex that remembers how it was used.
+ - Meets the Lockable requirements (lock / try_lock / unlock), so it works with lock_guard,
+   unique_lock, scoped_lock and std::lock exactly like std::mutex.
+ - Per lock it records: acquisitions, contended acquisitions (the first try_lock failed),
+   a wait-time histogram and a hold-time histogram (power-of-two buckets in ns).
+ - Cheap enough to leave on: the uncontended path is one try_lock plus two timestamp reads
+   (rdtsc on x86). Counters are only written while the mutex is held, so they are plain
+   relaxed load+store, never a locked read-modify-write.
+ - Locks with the same name (e.g. every "account" lock) are summed up in the report.
+ - LockProfiler::report() prints the top-N locks sorted by total time spent waiting.
+*/
+
+namespace lockprof {
+
+inline uint64_t ticks() {
+#if LOCKPROF_RDTSC
+	return __rdtsc();
+#else
+	return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// ticks -> nanoseconds, measured once
+inline double nanosPerTick() {
+	static const double ratio = [] {
+		auto t0 = std::chrono::steady_clock::now();
+		uint64_t c0 = ticks();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		uint64_t c1 = ticks();
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+		return c1 > c0 ? ns / static_cast<double>(c1 - c0) : 1.0;
+	}();
+	return ratio;
+}
+
+constexpr int Buckets = 40; // bucket b holds durations in [2^(b-1), 2^b) ticks
+
+inline int bucketOf(uint64_t t) {
+	int b = 0;
+	while (t && b < Buckets - 1) {
+		t >>= 1;
+		b++;
+	}
+	return b;
+}
+
+// Plain numbers, used for snapshots and for stats of destroyed locks.
+struct StatsData {
+	uint64_t acquisitions = 0;
+	uint64_t contended = 0;
+	uint64_t failedTries = 0;
+	uint64_t waitTicks = 0;
+	uint64_t holdTicks = 0;
+	uint64_t waitHist[Buckets] = {};
+	uint64_t holdHist[Buckets] = {};
+
+	StatsData& operator+=(const StatsData& o) {
+		acquisitions += o.acquisitions;
+		contended += o.contended;
+		failedTries += o.failedTries;
+		waitTicks += o.waitTicks;
+		holdTicks += o.holdTicks;
+		for (int b = 0; b < Buckets; b++) {
+			waitHist[b] += o.waitHist[b];
+			holdHist[b] += o.holdHist[b];
+		}
+		return *this;
+	}
+};
+
+// Live counters inside each mutex. Only the lock holder writes them.
+struct LiveStats {
+	std::atomic<uint64_t> acquisitions{ 0 }, contended{ 0 }, failedTries{ 0 }, waitTicks{ 0 }, holdTicks{ 0 };
+	std::atomic<uint64_t> waitHist[Buckets] = {}, holdHist[Buckets] = {};
+
+	static void bump(std::atomic<uint64_t>& c, uint64_t by = 1) {
+		c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+	}
+
+	StatsData read() const {
+		StatsData d;
+		d.acquisitions = acquisitions.load(std::memory_order_relaxed);
+		d.contended = contended.load(std::memory_order_relaxed);
+		d.failedTries = failedTries.load(std::memory_order_relaxed);
+		d.waitTicks = waitTicks.load(std::memory_order_relaxed);
+		d.holdTicks = holdTicks.load(std::memory_order_relaxed);
+		for (int b = 0; b < Buckets; b++) {
+			d.waitHist[b] = waitHist[b].load(std::memory_order_relaxed);
+			d.holdHist[b] = holdHist[b].load(std::memory_order_relaxed);
+		}
+		return d;
+	}
+};
+
+} // namespace lockprof
+
+class ProfiledMutex;
+
+class LockProfiler {
+public:
+	struct Row {
+		std::string name;
+		size_t locks = 0;
+		lockprof::StatsData stats;
+	};
+
+	static LockProfiler& instance() {
+		static LockProfiler* p = new LockProfiler; // never destroyed: mutexes may die after main
+		return *p;
+	}
+
+	// Per-name totals of every live and destroyed ProfiledMutex, most waited-on first.
+	std::vector<Row> snapshot();
+
+	void report(std::ostream& os, size_t topN = 10);
+
+private:
+	friend class ProfiledMutex;
+	std::mutex mtx_;
+	std::vector<ProfiledMutex*> live_;
+	std::map<std::string, Row> retired_;
+
+	void add(ProfiledMutex* m) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		live_.push_back(m);
+	}
+	void remove(ProfiledMutex* m);
+};
+
+class ProfiledMutex {
+public:
+	explicit ProfiledMutex(const char* name) : name_(name) { LockProfiler::instance().add(this); }
+	~ProfiledMutex() { LockProfiler::instance().remove(this); }
+
+	ProfiledMutex(const ProfiledMutex&) = delete;
+	ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+	void lock() {
+		if (mtx_.try_lock()) {
+			acquired(0, false);
+			return;
+		}
+		uint64_t start = lockprof::ticks();
+		mtx_.lock();
+		acquired(lockprof::ticks() - start, true);
+	}
+
+	bool try_lock() {
+		if (mtx_.try_lock()) {
+			acquired(0, false);
+			return true;
+		}
+		// counted without the lock held, so this one needs a real atomic add
+		stats_.failedTries.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	void unlock() {
+		uint64_t held = lockprof::ticks() - lockedAt_;
+		lockprof::LiveStats::bump(stats_.holdTicks, held);
+		lockprof::LiveStats::bump(stats_.holdHist[lockprof::bucketOf(held)]);
+		mtx_.unlock();
+	}
+
+	const std::string& name() const { return name_; }
+	lockprof::StatsData stats() const { return stats_.read(); }
+
+private:
+	std::mutex mtx_;
+	std::string name_;
+	uint64_t lockedAt_ = 0;
+	lockprof::LiveStats stats_;
+
+	void acquired(uint64_t waited, bool contended) {
+		using lockprof::LiveStats;
+		LiveStats::bump(stats_.acquisitions);
+		if (contended) {
+			LiveStats::bump(stats_.contended);
+			LiveStats::bump(stats_.waitTicks, waited);
+		}
+		LiveStats::bump(stats_.waitHist[lockprof::bucketOf(waited)]);
+		lockedAt_ = lockprof::ticks();
+	}
+};
+
+inline void LockProfiler::remove(ProfiledMutex* m) {
+	std::lock_guard<std::mutex> lock(mtx_);
+	live_.erase(std::remove(live_.begin(), live_.end(), m), live_.end());
+	Row& r = retired_[m->name()];
+	r.name = m->name();
+	r.locks++;
+	r.stats += m->stats();
+}
+
+inline std::vector<LockProfiler::Row> LockProfiler::snapshot() {
+	std::map<std::string, Row> byName;
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		byName = retired_;
+		for (ProfiledMutex* m : live_) {
+			Row& r = byName[m->name()];
+			r.name = m->name();
+			r.locks++;
+			r.stats += m->stats();
+		}
+	}
+	std::vector<Row> rows;
+	for (auto& kv : byName) rows.push_back(kv.second);
+	std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+		return a.stats.waitTicks > b.stats.waitTicks;
+	});
+	return rows;
+}
+
+inline void LockProfiler::report(std::ostream& os, size_t topN) {
+	double nsPerTick = lockprof::nanosPerTick();
+	// upper edge of the bucket that contains the p-th percentile, in ns
+	auto pct = [nsPerTick](const uint64_t* hist, uint64_t total, double p) {
+		if (total == 0) return 0.0;
+		uint64_t want = static_cast<uint64_t>(p / 100.0 * total), seen = 0;
+		for (int b = 0; b < lockprof::Buckets; b++) {
+			seen += hist[b];
+			if (seen > want) return b == 0 ? 0.0 : static_cast<double>(1ull << b) * nsPerTick;
+		}
+		return static_cast<double>(1ull << (lockprof::Buckets - 1)) * nsPerTick;
+	};
+
+	std::vector<Row> rows = snapshot();
+	char line[256];
+	std::snprintf(line, sizeof(line), "%-20s %5s %12s %10s %7s %12s %10s %10s %10s %10s\n", "lock", "#", "acquired",
+		"contended", "cont%", "wait ms", "wait p50", "wait p99", "hold p50", "hold p99");
+	os << line;
+	for (size_t i = 0; i < rows.size() && i < topN; i++) {
+		const auto& s = rows[i].stats;
+		std::snprintf(line, sizeof(line), "%-20s %5zu %12llu %10llu %6.2f%% %12.3f %10.0f %10.0f %10.0f %10.0f\n",
+			rows[i].name.c_str(), rows[i].locks, static_cast<unsigned long long>(s.acquisitions),
+			static_cast<unsigned long long>(s.contended), s.acquisitions ? 100.0 * s.contended / s.acquisitions : 0.0,
+			s.waitTicks * nsPerTick / 1e6, pct(s.waitHist, s.acquisitions, 50), pct(s.waitHist, s.acquisitions, 99),
+			pct(s.holdHist, s.acquisitions, 50), pct(s.holdHist, s.acquisitions, 99));
+		os << line;
+	}
+}
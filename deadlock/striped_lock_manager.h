@@ -0,0 +1,108 @@
+#pragma once
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+
+/*
+Striped lock manager for multi-resource transactions (e.g. bank transfers between accounts).
+ - One std::mutex per account: 1M accounts = 40+ MB of mutexes, mostly idle.
+ - One global mutex: every transfer waits for every other transfer.
+ - Middle ground: a fixed array of stripes (mutexes), each on its own cache line.
+   A resource id is hashed onto a stripe, so unrelated accounts rarely share a lock.
+ - Deadlock avoidance is the same idea as deadlock.cpp's "consistent lock order":
+   the needed stripes are sorted and locked in ascending order. Two ids that hash to the same
+   stripe are deduplicated, otherwise we would lock the same std::mutex twice.
+*/
+class StripedLockManager {
+public:
+	static constexpr size_t CacheLine = 64;
+
+	// RAII owner of a set of stripes; unlocks them in reverse order when it goes out of scope.
+	class Guard {
+	public:
+		Guard(Guard&& other) noexcept : mgr_(other.mgr_), count_(other.count_) {
+			// inline_ is only written when overflow_ is unused; check before moving overflow_ out
+			if (other.overflow_.empty()) std::copy(other.inline_, other.inline_ + count_, inline_);
+			else overflow_ = std::move(other.overflow_);
+			other.mgr_ = nullptr;
+		}
+		Guard(const Guard&) = delete;
+		Guard& operator=(const Guard&) = delete;
+		Guard& operator=(Guard&&) = delete;
+
+		~Guard() {
+			if (!mgr_) return;
+			for (size_t i = count_; i-- > 0;) mgr_->stripes_[at(i)].mtx.unlock();
+		}
+
+		size_t stripesHeld() const { return count_; }
+
+	private:
+		friend class StripedLockManager;
+		static constexpr size_t InlineStripes = 8; // transfers need 2; no allocation below 8
+
+		StripedLockManager* mgr_;
+		size_t count_ = 0;
+		uint32_t inline_[InlineStripes];
+		std::vector<uint32_t> overflow_;
+
+		explicit Guard(StripedLockManager* mgr) : mgr_(mgr) {}
+
+		uint32_t* data() { return overflow_.empty() ? inline_ : overflow_.data(); }
+		uint32_t at(size_t i) const { return overflow_.empty() ? inline_[i] : overflow_[i]; }
+	};
+
+	// stripes is rounded up to a power of two so the hash can be masked instead of divided
+	explicit StripedLockManager(size_t stripes = 4096) {
+		size_t n = 1;
+		while (n < stripes) n <<= 1;
+		mask_ = n - 1;
+		stripes_ = std::make_unique<Stripe[]>(n);
+	}
+
+	StripedLockManager(const StripedLockManager&) = delete;
+	StripedLockManager& operator=(const StripedLockManager&) = delete;
+
+	size_t stripeCount() const { return mask_ + 1; }
+
+	size_t stripeOf(uint64_t id) const {
+		// Fibonacci hashing: spreads consecutive ids over all stripes
+		return static_cast<size_t>((id * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+	}
+
+	Guard lock(uint64_t a, uint64_t b) { return lockAll({ a, b }); }
+
+	Guard lockAll(std::initializer_list<uint64_t> ids) { return lockAll(ids.begin(), ids.end()); }
+
+	template <typename It>
+	Guard lockAll(It first, It last) {
+		Guard g(this);
+		size_t n = static_cast<size_t>(std::distance(first, last));
+		if (n > Guard::InlineStripes) g.overflow_.resize(n);
+		uint32_t* s = g.data();
+		size_t k = 0;
+		for (It it = first; it != last; ++it) s[k++] = static_cast<uint32_t>(stripeOf(*it));
+
+		// sort + dedup: fixed global order, and never the same mutex twice
+		std::sort(s, s + k);
+		k = static_cast<size_t>(std::unique(s, s + k) - s);
+		if (!g.overflow_.empty()) g.overflow_.resize(k);
+
+		for (size_t i = 0; i < k; i++) {
+			stripes_[s[i]].mtx.lock();
+			g.count_ = i + 1; // keep the guard exact if lock() throws
+		}
+		return g;
+	}
+
+private:
+	struct alignas(CacheLine) Stripe {
+		std::mutex mtx;
+	};
+
+	size_t mask_;
+	std::unique_ptr<Stripe[]> stripes_;
+};
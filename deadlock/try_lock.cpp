@@ -40,6 +40,7 @@ void taskB()
 
 //The moment std::try_lock fails on any mutex,
 //it immediately stops and returns the index of the mutex that couldn't be locked.
+//To retry with randomized backoff (bounded retries / deadline) instead of giving up, see lockWithBackoff() in backoff_lock.h.
 
 int main() {
 
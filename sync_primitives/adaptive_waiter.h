@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+/*
+Spin-then-park waiting:
+ - fut.get() / cv.wait() put the thread to sleep in the kernel right away. If the value shows up
+   a few hundred ns later, we still pay the full sleep + wake-up (several microseconds).
+ - AdaptiveWaiter first spins with a CPU pause hint, then yields its time slice a few times,
+   and only then parks (the caller says how: atomic::wait, cv.wait, ...).
+ - How long to spin is learned: each wait records how long it actually took. Waits that finish
+   within the cost of a park/wake-up pull the budget up (spinning would have caught them);
+   longer waits pull it down towards a tiny spin (spinning would only burn CPU).
+ - The park/wake-up cost itself is measured once per process (parkCostNs()).
+*/
+
+inline void cpuRelax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield" ::: "memory");
+#else
+	std::this_thread::yield();
+#endif
+}
+
+class AdaptiveWaiter {
+public:
+	static constexpr long long MinSpinNs = 50;
+	static constexpr int MaxYields = 8;
+
+	struct Stats {
+		std::atomic<long long> spun{ 0 };    // satisfied while spinning
+		std::atomic<long long> yielded{ 0 }; // satisfied while yielding
+		std::atomic<long long> parked{ 0 };  // had to sleep
+	};
+
+	AdaptiveWaiter() : spinBudgetNs_(std::min<long long>(1000, maxSpinNs())) {}
+
+	// Waits until ready() is true. park() must block until the state may have changed
+	// (it may return spuriously; ready() is re-checked).
+	template <typename Ready, typename Park>
+	void wait(Ready&& ready, Park&& park) {
+		if (ready()) return;
+		auto start = std::chrono::steady_clock::now();
+		long long budget = spinBudgetNs_.load(std::memory_order_relaxed);
+
+		// phase 1: spin. The clock is only read every 32 pauses.
+		for (unsigned i = 1;; i++) {
+			cpuRelax();
+			if (ready()) return finish(start, stats_.spun);
+			if ((i & 31) == 0 && elapsedNs(start) >= budget) break;
+		}
+		// phase 2: give the core away, but stay runnable
+		for (int i = 0; i < MaxYields; i++) {
+			std::this_thread::yield();
+			if (ready()) return finish(start, stats_.yielded);
+		}
+		// phase 3: sleep in the kernel
+		while (!ready()) park();
+		finish(start, stats_.parked);
+	}
+
+	// Common case: wait until an atomic no longer holds 'old'. Notifiers use a.notify_one()/notify_all().
+	template <typename T>
+	void waitWhileEqual(const std::atomic<T>& a, T old, std::memory_order order = std::memory_order_acquire) {
+		wait([&] { return a.load(order) != old; }, [&] { a.wait(old, order); });
+	}
+
+	long long spinBudgetNs() const { return spinBudgetNs_.load(std::memory_order_relaxed); }
+	const Stats& stats() const { return stats_; }
+
+	// Round-trip cost of parking a thread and waking it up again, measured once.
+	static long long parkCostNs() {
+		static const long long cost = calibrateParkCost();
+		return cost;
+	}
+
+	// Spinning longer than ~2 park/wake-ups never pays off.
+	static long long maxSpinNs() { return 2 * parkCostNs(); }
+
+private:
+	std::atomic<long long> spinBudgetNs_;
+	Stats stats_;
+
+	static long long elapsedNs(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void finish(std::chrono::steady_clock::time_point start, std::atomic<long long>& counter) {
+		counter.fetch_add(1, std::memory_order_relaxed);
+		long long waited = elapsedNs(start);
+		long long budget = spinBudgetNs_.load(std::memory_order_relaxed);
+		long long limit = maxSpinNs();
+		// spinning to twice the observed wait would have caught it -> move towards that,
+		// otherwise decay towards the minimum. EWMA with weight 1/8.
+		long long target = waited <= limit ? std::min(limit, 2 * waited) : MinSpinNs;
+		budget += (target - budget) / 8;
+		spinBudgetNs_.store(std::clamp(budget, MinSpinNs, limit), std::memory_order_relaxed);
+	}
+
+	static long long calibrateParkCost() {
+		constexpr int Rounds = 64;
+		std::atomic<int> turn{ 0 };
+		std::vector<long long> samples;
+		samples.reserve(Rounds);
+		std::thread partner([&] {
+			for (int i = 0; i < Rounds; i++) {
+				turn.wait(2 * i);                  // park until main hands the turn over
+				turn.store(2 * i + 2);
+				turn.notify_one();
+			}
+		});
+		for (int i = 0; i < Rounds; i++) {
+			auto start = std::chrono::steady_clock::now();
+			turn.store(2 * i + 1);
+			turn.notify_one();
+			turn.wait(2 * i + 1);
+			samples.push_back(elapsedNs(start) / 2); // two wake-ups per round trip
+		}
+		partner.join();
+		std::nth_element(samples.begin(), samples.begin() + Rounds / 2, samples.end());
+		return std::clamp<long long>(samples[Rounds / 2], 500, 100000);
+	}
+};
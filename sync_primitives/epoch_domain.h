@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <functional>
+#include <cstdint>
+#include <limits>
+
+/*
+Epoch-based reclamation (EBR), the "grace period" half of RCU.
+ - Readers announce "I'm reading, and I started in epoch E" in their own per-thread slot:
+   a plain store plus a fence, no read-modify-write on any shared line.
+ - A writer that unlinks an object retires it with the current epoch and advances the epoch.
+ - The object is freed once every reader that is still inside a read section started in a
+   later epoch: nobody can still hold a pointer to it.
+ - One process-wide domain (instance()) is shared by every Snapshot<T>.
+*/
+class EpochDomain {
+public:
+	static constexpr size_t CacheLine = 64;
+	static constexpr uint64_t Quiescent = 0; // slot value when the thread is not reading
+
+	static EpochDomain& instance() {
+		static EpochDomain* d = new EpochDomain; // never destroyed: thread exit may come later
+		return *d;
+	}
+
+	// Start / end of a read section. Nested sections are allowed.
+	void enter() {
+		ThreadRecord& r = record();
+		if (r.nesting++ == 0) {
+			r.epoch.store(globalEpoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			// publish our epoch before reading any protected pointer
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+	}
+
+	void exit() {
+		ThreadRecord& r = record();
+		if (--r.nesting == 0) r.epoch.store(Quiescent, std::memory_order_release);
+	}
+
+	// Hands an unlinked object over; it is destroyed after its grace period.
+	void retire(void* ptr, void (*deleter)(void*)) {
+		std::atomic_thread_fence(std::memory_order_seq_cst); // unlink happens-before the scan
+		uint64_t e = globalEpoch_.fetch_add(1, std::memory_order_acq_rel);
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			retired_.push_back({ ptr, deleter, e });
+		}
+		reclaim();
+	}
+
+	// Frees everything whose grace period is over. Returns how many objects are still pending.
+	size_t reclaim() {
+		std::vector<Retired> ready;
+		size_t pending;
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			uint64_t minActive = oldestActiveEpoch();
+			auto keep = retired_.begin();
+			for (auto it = retired_.begin(); it != retired_.end(); ++it) {
+				if (it->epoch < minActive) ready.push_back(*it);
+				else *keep++ = *it;
+			}
+			retired_.erase(keep, retired_.end());
+			pending = retired_.size();
+		}
+		for (auto& r : ready) r.deleter(r.ptr); // outside the lock: destructors may be slow
+		return pending;
+	}
+
+	// Blocks until everything retired so far has been freed.
+	void synchronize() {
+		while (reclaim() != 0) std::this_thread::yield();
+	}
+
+private:
+	struct alignas(CacheLine) ThreadRecord {
+		std::atomic<uint64_t> epoch{ Quiescent };
+		int nesting = 0;                 // only touched by the owning thread
+		std::atomic<bool> inUse{ false };
+	};
+
+	struct Retired {
+		void* ptr;
+		void (*deleter)(void*);
+		uint64_t epoch;
+	};
+
+	// Returns its record to the pool when the thread exits.
+	struct RecordHandle {
+		ThreadRecord* rec = nullptr;
+		~RecordHandle() {
+			if (rec) rec->inUse.store(false, std::memory_order_release);
+		}
+	};
+
+	std::atomic<uint64_t> globalEpoch_{ 1 }; // starts at 1 so 0 can mean "quiescent"
+	std::mutex mtx_;
+	std::vector<Retired> retired_;
+	std::mutex recordsMtx_;
+	std::vector<std::unique_ptr<ThreadRecord>> records_; // only grows; records are reused
+
+	ThreadRecord& record() {
+		thread_local RecordHandle handle;
+		if (!handle.rec) handle.rec = acquireRecord();
+		return *handle.rec;
+	}
+
+	ThreadRecord* acquireRecord() {
+		std::lock_guard<std::mutex> lock(recordsMtx_);
+		for (auto& r : records_) {
+			bool expected = false;
+			if (r->inUse.compare_exchange_strong(expected, true)) return r.get();
+		}
+		records_.push_back(std::make_unique<ThreadRecord>());
+		records_.back()->inUse.store(true);
+		return records_.back().get();
+	}
+
+	uint64_t oldestActiveEpoch() {
+		uint64_t oldest = std::numeric_limits<uint64_t>::max();
+		std::lock_guard<std::mutex> lock(recordsMtx_);
+		for (auto& r : records_) {
+			uint64_t e = r->epoch.load(std::memory_order_acquire);
+			if (e != Quiescent && e < oldest) oldest = e;
+		}
+		return oldest;
+	}
+};
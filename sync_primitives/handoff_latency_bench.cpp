@@ -0,0 +1,115 @@
+// Benchmark: handoff latency of kernel-parking waits vs. AdaptiveWaiter (spin -> yield -> park).
+// usage: handoff_latency_bench [rounds=20000]
+//
+// The producer waits 'delay' ns after the consumer has started waiting, then publishes a value.
+// Latency = publish -> consumer returns from its wait. Short delays are where spinning wins;
+// long delays show that the learned budget stops spinning and falls back to parking.
+#include <iostream>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include "adaptive_waiter.h"
+#include "../coroutines/awaitables.h"
+#include "../common/bench_util.h"
+
+void busyDelay(long long ns) {
+	long long until = bench::nowNanos() + ns;
+	while (bench::nowNanos() < until) cpuRelax();
+}
+
+// Runs one producer/consumer pair. waitFor(i) blocks until item i is there, publish(i) hands it over.
+template <typename WaitFor, typename Publish>
+std::vector<double> runHandoffs(int rounds, long long delayNs, WaitFor waitFor, Publish publish) {
+	std::vector<long long> setAt(rounds), gotAt(rounds);
+	std::atomic<int> consumerAt{ -1 };
+
+	std::thread consumer([&] {
+		for (int i = 0; i < rounds; i++) {
+			consumerAt.store(i, std::memory_order_release);
+			waitFor(i);
+			gotAt[i] = bench::nowNanos();
+		}
+	});
+	for (int i = 0; i < rounds; i++) {
+		while (consumerAt.load(std::memory_order_acquire) < i) std::this_thread::yield();
+		busyDelay(delayNs);
+		setAt[i] = bench::nowNanos();
+		publish(i);
+	}
+	consumer.join();
+
+	std::vector<double> lat(rounds);
+	for (int i = 0; i < rounds; i++) lat[i] = static_cast<double>(gotAt[i] - setAt[i]);
+	return lat;
+}
+
+void report(const char* name, std::vector<double> lat) {
+	printf("  %-28s p50 %7.0f  p90 %7.0f  p99 %8.0f  p99.9 %8.0f ns\n", name,
+		bench::percentile(lat, 50), bench::percentile(lat, 90), bench::percentile(lat, 99), bench::percentile(lat, 99.9));
+}
+
+// mutex + condition_variable queue, the textbook blocking channel
+struct CvQueue {
+	std::mutex mtx;
+	std::condition_variable cv;
+	std::deque<int> items;
+	void send(int v) {
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			items.push_back(v);
+		}
+		cv.notify_one();
+	}
+	int receive() {
+		std::unique_lock<std::mutex> lock(mtx);
+		cv.wait(lock, [this] { return !items.empty(); });
+		int v = items.front();
+		items.pop_front();
+		return v;
+	}
+};
+
+int main(int argc, char** argv) {
+	int rounds = static_cast<int>(bench::argOr(argc, argv, 1, 20000));
+	ThreadPool pool(1);
+
+	printf("park/wake-up cost (calibrated): %lld ns, max spin budget %lld ns\n\n",
+		AdaptiveWaiter::parkCostNs(), AdaptiveWaiter::maxSpinNs());
+
+	for (long long delay : { 0LL, 250LL, 1000LL, 5000LL, 50000LL }) {
+		printf("producer delay %lld ns (%d rounds)\n", delay, rounds);
+
+		std::vector<std::promise<int>> sp(rounds);
+		std::vector<std::future<int>> sf;
+		for (auto& p : sp) sf.push_back(p.get_future());
+		report("std::future::get", runHandoffs(rounds, delay,
+			[&](int i) { bench::doNotOptimize(sf[i].get()); }, [&](int i) { sp[i].set_value(i); }));
+
+		std::vector<AsyncPromise<int>> ap;
+		std::vector<AsyncFuture<int>> af;
+		for (int i = 0; i < rounds; i++) {
+			ap.emplace_back(pool);
+			af.push_back(ap.back().get_future());
+		}
+		report("AsyncFuture::get (adaptive)", runHandoffs(rounds, delay,
+			[&](int i) { bench::doNotOptimize(af[i].get()); }, [&](int i) { ap[i].set_value(i); }));
+
+		CvQueue q;
+		report("mutex+cv queue", runHandoffs(rounds, delay,
+			[&](int) { bench::doNotOptimize(q.receive()); }, [&](int i) { q.send(i); }));
+
+		Channel<int> ch(pool);
+		report("Channel::receive_blocking", runHandoffs(rounds, delay,
+			[&](int) { bench::doNotOptimize(*ch.receive_blocking()); }, [&](int i) { ch.send(i); }));
+
+		const auto& st = ch.blockingWaiter().stats();
+		printf("  channel waiter: spun %lld, yielded %lld, parked %lld, budget now %lld ns\n\n",
+			st.spun.load(), st.yielded.load(), st.parked.load(), ch.blockingWaiter().spinBudgetNs());
+	}
+	return 0;
+}
@@ -0,0 +1,187 @@
+// Benchmark: the odd/even handoff done five ways, measuring what print_odd_even.cpp only argues about.
+// usage: odd_even_bench [count=10000000] [latency sample every=64]
+//
+//  1. condition_variable  : the original program (minus the printing)
+//  2. mutex polling       : lock, check turn, unlock, repeat
+//  3. atomic spin         : spin on std::atomic<bool> with a pause hint
+//  4. atomic::wait        : C++20 futex-style wait/notify on the atomic
+//  5. binary_semaphore    : one semaphore per thread, release the other one
+//
+// Reported: handoffs/s, latency from "turn passed" to "other thread running", and CPU seconds
+// (user+sys from getrusage) - the busy-waiting versions burn ~2 cores even though only 1 works.
+// On a machine with a single hardware thread the spinning versions are far worse still: the waiter
+// spins away its whole time slice (milliseconds) before the other thread can run, so use a small count.
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <semaphore>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include "adaptive_waiter.h"
+#include "../common/bench_util.h"
+
+long long g_count;
+long long g_sampleEvery;
+
+// Shared by all variants: called by the thread that just got its turn.
+struct Recorder {
+	std::atomic<long long> passedAt{ 0 };
+	std::vector<double> samples;
+
+	void passing() { passedAt.store(bench::nowNanos(), std::memory_order_relaxed); }
+	void gotTurn(long long counter) {
+		if (counter % g_sampleEvery == 0) {
+			samples.push_back(static_cast<double>(bench::nowNanos() - passedAt.load(std::memory_order_relaxed)));
+		}
+	}
+};
+
+template <typename Body>
+void run(const char* name, Body body) {
+	Recorder rec;
+	rec.samples.reserve(static_cast<size_t>(g_count / g_sampleEvery + 2));
+	double cpu0 = bench::cpuSeconds();
+	bench::Stopwatch sw;
+	rec.passing();
+	body(rec);
+	double wall = sw.seconds();
+	double cpu = bench::cpuSeconds() - cpu0;
+	printf("%-18s %8.2f M/s  p50 %7.0f  p99 %8.0f  p99.9 %8.0f ns  cpu %6.2f s (%.2f cores)\n", name,
+		g_count / wall / 1e6, bench::percentile(rec.samples, 50), bench::percentile(rec.samples, 99),
+		bench::percentile(rec.samples, 99.9), cpu, cpu / wall);
+}
+
+void condVar(Recorder& rec) {
+	std::mutex mtx;
+	std::condition_variable cv;
+	bool isEvenTurn = false;
+	long long counter = 1;
+	auto worker = [&](bool even) {
+		while (true) {
+			std::unique_lock<std::mutex> lock(mtx);
+			cv.wait(lock, [&] { return isEvenTurn == even || counter > g_count; });
+			if (counter > g_count) break;
+			rec.gotTurn(counter);
+			counter++;
+			isEvenTurn = !even;
+			rec.passing();
+			cv.notify_one();
+		}
+		cv.notify_one();
+	};
+	std::thread t1(worker, false), t2(worker, true);
+	t1.join();
+	t2.join();
+}
+
+void mutexPolling(Recorder& rec) {
+	std::mutex mtx;
+	bool isEvenTurn = false;
+	long long counter = 1;
+	auto worker = [&](bool even) {
+		while (true) {
+			std::lock_guard<std::mutex> lock(mtx);
+			if (counter > g_count) break;
+			if (isEvenTurn != even) continue; // not our turn: unlock and ask again
+			rec.gotTurn(counter);
+			counter++;
+			isEvenTurn = !even;
+			rec.passing();
+		}
+	};
+	std::thread t1(worker, false), t2(worker, true);
+	t1.join();
+	t2.join();
+}
+
+void atomicSpin(Recorder& rec) {
+	std::atomic<bool> isEvenTurn{ false };
+	long long counter = 1; // protected by the turn handoff (release/acquire)
+	std::atomic<bool> done{ false };
+	auto worker = [&](bool even) {
+		while (true) {
+			while (isEvenTurn.load(std::memory_order_acquire) != even) {
+				if (done.load(std::memory_order_relaxed)) return;
+				cpuRelax();
+			}
+			if (counter > g_count) {
+				done = true;
+				isEvenTurn.store(!even, std::memory_order_release);
+				return;
+			}
+			rec.gotTurn(counter);
+			counter++;
+			rec.passing();
+			isEvenTurn.store(!even, std::memory_order_release);
+		}
+	};
+	std::thread t1(worker, false), t2(worker, true);
+	t1.join();
+	t2.join();
+}
+
+void atomicWait(Recorder& rec) {
+	std::atomic<bool> isEvenTurn{ false };
+	long long counter = 1;
+	std::atomic<bool> done{ false };
+	auto worker = [&](bool even) {
+		while (true) {
+			isEvenTurn.wait(!even, std::memory_order_acquire); // sleep while it is the other thread's turn
+			if (done.load(std::memory_order_relaxed)) return;
+			if (counter > g_count) {
+				done = true;
+				isEvenTurn.store(!even, std::memory_order_release);
+				isEvenTurn.notify_one();
+				return;
+			}
+			rec.gotTurn(counter);
+			counter++;
+			rec.passing();
+			isEvenTurn.store(!even, std::memory_order_release);
+			isEvenTurn.notify_one();
+		}
+	};
+	std::thread t1(worker, false), t2(worker, true);
+	t1.join();
+	t2.join();
+}
+
+void semaphores(Recorder& rec) {
+	std::binary_semaphore oddSem(1), evenSem(0);
+	long long counter = 1;
+	bool done = false;
+	auto worker = [&](std::binary_semaphore& mine, std::binary_semaphore& other) {
+		while (true) {
+			mine.acquire();
+			if (done || counter > g_count) {
+				done = true;
+				other.release();
+				return;
+			}
+			rec.gotTurn(counter);
+			counter++;
+			rec.passing();
+			other.release();
+		}
+	};
+	std::thread t1(worker, std::ref(oddSem), std::ref(evenSem));
+	std::thread t2(worker, std::ref(evenSem), std::ref(oddSem));
+	t1.join();
+	t2.join();
+}
+
+int main(int argc, char** argv) {
+	g_count = bench::argOr(argc, argv, 1, 10000000);
+	g_sampleEvery = std::max(1LL, bench::argOr(argc, argv, 2, 64));
+	printf("odd/even handoffs: %lld, hardware threads: %u\n", g_count, std::thread::hardware_concurrency());
+
+	run("condition_variable", condVar);
+	run("mutex polling", mutexPolling);
+	run("atomic spin", atomicSpin);
+	run("atomic::wait", atomicWait);
+	run("binary_semaphore", semaphores);
+	return 0;
+}
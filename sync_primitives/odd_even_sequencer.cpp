@@ -0,0 +1,39 @@
+// print_odd_even.cpp on top of the Sequencer: same "Odd:/Even:" output,
+// but each thread waits on its own slot and only the next thread is woken.
+#include <iostream>
+#include <thread>
+#include "sequencer.h"
+
+int counter = 1;
+const int MAX = 10;
+
+Sequencer seq(2); // stage 0 = odd, stage 1 = even
+
+void printer(size_t stage, const char* label) {
+	while (seq.waitTurn(stage)) {
+		if (counter > MAX) {
+			seq.stop(); // release the other thread too
+			break;
+		}
+		std::cout << label << counter << "\n";
+		counter++; // no lock needed: only the thread holding the turn touches counter
+		seq.passTurn(stage);
+	}
+}
+
+int main() {
+	std::thread t1(printer, 0, "Odd: ");
+	std::thread t2(printer, 1, "Even: ");
+
+	t1.join();
+	t2.join();
+
+	return 0;
+}
+
+/*
+Why counter needs no mutex here:
+ - passTurn() stores with memory_order_release and waitTurn() loads with acquire, so everything
+   the previous stage wrote (counter++) is visible to the next stage before it runs.
+ - The same code works for N stages: Sequencer seq(N) and one printer per stage.
+*/
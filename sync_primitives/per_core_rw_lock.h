@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <algorithm>
+#include "adaptive_waiter.h"
+
+/*
+PerCoreRWLock: reader-writer lock whose readers do not share a counter.
+ - std::shared_mutex keeps one reader count; every lock_shared()/unlock_shared() is an atomic
+   RMW on that one cache line, so with many reader threads the line ping-pongs between cores
+   and reads stop scaling even though nobody ever writes.
+ - Here readers are spread over one counter per slot, each on its own cache line. A thread is
+   given a slot the first time it reads (round-robin) and keeps it, so on a machine with at least
+   as many slots as cores, readers on different cores touch different lines.
+ - A writer raises the writer flag and then waits for every slot to drain; readers that see the
+   flag back out and wait. Writes are therefore expensive (O(slots)) - fine for 0.01% writes.
+ - Satisfies SharedMutex: works with std::unique_lock and std::shared_lock.
+*/
+class PerCoreRWLock {
+public:
+	static constexpr size_t CacheLine = 64;
+
+	explicit PerCoreRWLock(size_t slots = std::max(1u, std::thread::hardware_concurrency()))
+		: slotCount_(std::max<size_t>(1, slots)), slots_(std::make_unique<Slot[]>(slotCount_)) {}
+
+	PerCoreRWLock(const PerCoreRWLock&) = delete;
+	PerCoreRWLock& operator=(const PerCoreRWLock&) = delete;
+
+	void lock_shared() {
+		Slot& s = mySlot();
+		while (true) {
+			s.readers.fetch_add(1, std::memory_order_seq_cst);
+			if (!writer_.load(std::memory_order_seq_cst)) return;
+			// a writer is active or waiting: step aside so it can drain the slots
+			s.readers.fetch_sub(1, std::memory_order_release);
+			writer_.wait(true, std::memory_order_acquire);
+		}
+	}
+
+	bool try_lock_shared() {
+		Slot& s = mySlot();
+		s.readers.fetch_add(1, std::memory_order_seq_cst);
+		if (!writer_.load(std::memory_order_seq_cst)) return true;
+		s.readers.fetch_sub(1, std::memory_order_release);
+		return false;
+	}
+
+	void unlock_shared() { mySlot().readers.fetch_sub(1, std::memory_order_release); }
+
+	void lock() {
+		writeMtx_.lock();
+		writer_.store(true, std::memory_order_seq_cst);
+		for (size_t i = 0; i < slotCount_; i++) {
+			AdaptiveWaiter& w = slots_[i].drainWaiter;
+			w.wait([&] { return slots_[i].readers.load(std::memory_order_acquire) == 0; },
+				[] { std::this_thread::yield(); });
+		}
+	}
+
+	bool try_lock() {
+		if (!writeMtx_.try_lock()) return false;
+		writer_.store(true, std::memory_order_seq_cst);
+		for (size_t i = 0; i < slotCount_; i++) {
+			if (slots_[i].readers.load(std::memory_order_acquire) != 0) {
+				unlock();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void unlock() {
+		writer_.store(false, std::memory_order_release);
+		writer_.notify_all();
+		writeMtx_.unlock();
+	}
+
+private:
+	struct alignas(CacheLine) Slot {
+		std::atomic<long> readers{ 0 };
+		AdaptiveWaiter drainWaiter; // only used by the (single) writer
+	};
+
+	size_t slotCount_;
+	std::unique_ptr<Slot[]> slots_;
+	alignas(CacheLine) std::atomic<bool> writer_{ false };
+	std::mutex writeMtx_;
+
+	Slot& mySlot() {
+		static std::atomic<size_t> nextThread{ 0 };
+		thread_local size_t index = nextThread.fetch_add(1, std::memory_order_relaxed);
+		return slots_[index % slotCount_];
+	}
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "adaptive_waiter.h"
+
+/*
+SeqLock<T>: sequence lock for small, trivially copyable snapshots (a few cache lines at most).
+ - Readers never write shared memory: they read the sequence number, copy the data, and read
+   the sequence number again. Odd or changed -> a write was in progress, copy again.
+ - Writers bump the sequence to odd, write, bump it to even. Writers are serialized by a mutex.
+ - Ideal for read-mostly config: readers scale perfectly because no cache line bounces
+   between them. Writers are never blocked by readers (readers just retry).
+ - The payload is stored as relaxed atomic words, so the racy copy is well-defined C++
+   rather than a data race on plain memory.
+*/
+template <typename T>
+class SeqLock {
+	static_assert(std::is_trivially_copyable_v<T>, "SeqLock needs a trivially copyable T");
+
+public:
+	SeqLock() : SeqLock(T{}) {}
+	explicit SeqLock(const T& initial) { storeWords(initial); }
+
+	SeqLock(const SeqLock&) = delete;
+	SeqLock& operator=(const SeqLock&) = delete;
+
+	T load() const {
+		T out;
+		while (true) {
+			uint64_t s1 = seq_.load(std::memory_order_acquire);
+			if (s1 & 1) { // writer active
+				cpuRelax();
+				continue;
+			}
+			loadWords(out);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (seq_.load(std::memory_order_relaxed) == s1) return out;
+		}
+	}
+
+	void store(const T& value) {
+		std::lock_guard<std::mutex> lock(writeMtx_);
+		uint64_t s = seq_.load(std::memory_order_relaxed);
+		seq_.store(s + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		storeWords(value);
+		seq_.store(s + 2, std::memory_order_release);
+	}
+
+	// Read-modify-write under the writer lock: update([](T& cfg) { cfg.x++; });
+	template <typename F>
+	void update(F&& f) {
+		std::lock_guard<std::mutex> lock(writeMtx_);
+		T value;
+		loadWords(value); // no writer can run concurrently, so this copy is consistent
+		f(value);
+		uint64_t s = seq_.load(std::memory_order_relaxed);
+		seq_.store(s + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		storeWords(value);
+		seq_.store(s + 2, std::memory_order_release);
+	}
+
+private:
+	static constexpr size_t Words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	alignas(64) std::atomic<uint64_t> seq_{ 0 };
+	std::atomic<uint64_t> words_[Words] = {};
+	std::mutex writeMtx_;
+
+	void loadWords(T& out) const {
+		uint64_t buf[Words];
+		for (size_t i = 0; i < Words; i++) buf[i] = words_[i].load(std::memory_order_relaxed);
+		std::memcpy(&out, buf, sizeof(T));
+	}
+
+	void storeWords(const T& value) {
+		uint64_t buf[Words] = {};
+		std::memcpy(buf, &value, sizeof(T));
+		for (size_t i = 0; i < Words; i++) words_[i].store(buf[i], std::memory_order_relaxed);
+	}
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include "adaptive_waiter.h"
+
+/*
+Sequencer: N stages take turns in a fixed round-robin order (0, 1, ..., N-1, 0, ...).
+ - The odd/even program uses one mutex + one condition_variable for everybody, so every step
+   wakes (or at least disturbs) every waiting thread.
+ - Here each stage owns its own slot on its own cache line. passTurn(k) writes only slot k+1
+   and notifies only that slot, so exactly one thread wakes per step.
+ - Waiting goes through an AdaptiveWaiter per slot: quick handoffs are caught while spinning,
+   slow ones park on std::atomic::wait.
+*/
+class Sequencer {
+public:
+	static constexpr size_t CacheLine = 64;
+
+	explicit Sequencer(size_t stages, size_t first = 0)
+		: n_(stages), slots_(std::make_unique<Slot[]>(stages)) {
+		slots_[first % n_].state.store(Go, std::memory_order_relaxed);
+	}
+
+	Sequencer(const Sequencer&) = delete;
+	Sequencer& operator=(const Sequencer&) = delete;
+
+	size_t stages() const { return n_; }
+
+	// Blocks until it is stage k's turn. Returns false if the sequencer was stopped.
+	bool waitTurn(size_t k) {
+		Slot& s = slots_[k];
+		s.waiter.waitWhileEqual(s.state, Wait);
+		// consume the turn; fails only if stop() got there first
+		uint32_t expected = Go;
+		return s.state.compare_exchange_strong(expected, Wait, std::memory_order_acquire);
+	}
+
+	// Hands the turn from stage k to stage k+1. Only Wait -> Go: a racing stop() must stay stopped.
+	void passTurn(size_t k) {
+		Slot& next = slots_[(k + 1) % n_];
+		uint32_t expected = Wait;
+		if (next.state.compare_exchange_strong(expected, Go, std::memory_order_release, std::memory_order_relaxed)) {
+			next.state.notify_one();
+		}
+	}
+
+	// Releases every stage; their waitTurn() returns false from now on.
+	void stop() {
+		for (size_t i = 0; i < n_; i++) {
+			slots_[i].state.store(Stopped, std::memory_order_release);
+			slots_[i].state.notify_all();
+		}
+	}
+
+	const AdaptiveWaiter& waiter(size_t k) const { return slots_[k].waiter; }
+
+private:
+	static constexpr uint32_t Wait = 0, Go = 1, Stopped = 2;
+
+	struct alignas(CacheLine) Slot {
+		std::atomic<uint32_t> state{ Wait };
+		AdaptiveWaiter waiter;
+	};
+
+	size_t n_;
+	std::unique_ptr<Slot[]> slots_;
+};
@@ -0,0 +1,72 @@
+// Benchmark: N threads taking turns, Sequencer vs. the shared mutex + condition_variable design.
+// usage: sequencer_bench [handoffs per N=200000] [max N=16]
+//
+// With more than two threads the cv version has to notify_all(): notify_one() may wake a thread
+// whose turn it is not, and then nobody makes progress. That is exactly the cost being measured.
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <cstdio>
+#include "sequencer.h"
+#include "../common/bench_util.h"
+
+double runSequencer(size_t n, long long handoffs) {
+	Sequencer seq(n);
+	long long counter = 0;
+	std::vector<std::thread> threads;
+	bench::Stopwatch sw;
+	for (size_t k = 0; k < n; k++) {
+		threads.emplace_back([&, k] {
+			while (seq.waitTurn(k)) {
+				if (counter >= handoffs) {
+					seq.stop();
+					break;
+				}
+				counter++;
+				seq.passTurn(k);
+			}
+		});
+	}
+	for (auto& t : threads) t.join();
+	return handoffs / sw.seconds();
+}
+
+double runCondVar(size_t n, long long handoffs) {
+	std::mutex mtx;
+	std::condition_variable cv;
+	size_t turn = 0;
+	long long counter = 0;
+	std::vector<std::thread> threads;
+	bench::Stopwatch sw;
+	for (size_t k = 0; k < n; k++) {
+		threads.emplace_back([&, k] {
+			while (true) {
+				std::unique_lock<std::mutex> lock(mtx);
+				cv.wait(lock, [&] { return turn == k || counter >= handoffs; });
+				if (counter >= handoffs) break;
+				counter++;
+				turn = (k + 1) % n;
+				if (n == 2) cv.notify_one();
+				else cv.notify_all();
+			}
+			cv.notify_all();
+		});
+	}
+	for (auto& t : threads) t.join();
+	return handoffs / sw.seconds();
+}
+
+int main(int argc, char** argv) {
+	long long handoffs = bench::argOr(argc, argv, 1, 200000);
+	size_t maxN = static_cast<size_t>(bench::argOr(argc, argv, 2, 16));
+
+	printf("%4s %18s %18s %8s\n", "N", "cv handoffs/s", "sequencer/s", "speedup");
+	for (size_t n = 2; n <= maxN; n++) {
+		double cv = runCondVar(n, handoffs);
+		double sq = runSequencer(n, handoffs);
+		printf("%4zu %18.0f %18.0f %7.2fx\n", n, cv, sq, sq / cv);
+	}
+	return 0;
+}
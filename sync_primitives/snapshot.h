@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "epoch_domain.h"
+
+/*
+Snapshot<T>: RCU-style holder for a hot-swappable, read-mostly object (e.g. a config).
+ - read() returns a guard that behaves like a const T*. The fast path is: store our epoch in
+   our own slot, one fence, one atomic pointer load. No lock, no RMW, no shared counter.
+ - publish()/update() build a new version and swap the pointer. The old version stays alive
+   until every reader that might still see it has left its read section (EpochDomain).
+ - T can be anything (strings, vectors, maps) - unlike SeqLock, which needs trivially copyable data.
+ - Keep read guards short: a reader parked inside read() delays reclamation of every version.
+*/
+template <typename T>
+class Snapshot {
+public:
+	class ReadGuard {
+	public:
+		explicit ReadGuard(const Snapshot& s) {
+			EpochDomain::instance().enter();
+			ptr_ = s.current_.load(std::memory_order_acquire);
+		}
+		~ReadGuard() { EpochDomain::instance().exit(); }
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+
+		const T& operator*() const { return *ptr_; }
+		const T* operator->() const { return ptr_; }
+		const T* get() const { return ptr_; }
+
+	private:
+		const T* ptr_;
+	};
+
+	explicit Snapshot(std::unique_ptr<T> initial = std::make_unique<T>()) : current_(initial.release()) {}
+
+	~Snapshot() {
+		// no readers may be left at this point
+		delete current_.load(std::memory_order_relaxed);
+	}
+
+	Snapshot(const Snapshot&) = delete;
+	Snapshot& operator=(const Snapshot&) = delete;
+
+	ReadGuard read() const { return ReadGuard(*this); }
+
+	// Installs a new version; the old one is freed after its grace period.
+	void publish(std::unique_ptr<T> next) {
+		T* old = current_.exchange(next.release(), std::memory_order_acq_rel);
+		EpochDomain::instance().retire(old, [](void* p) { delete static_cast<T*>(p); });
+	}
+
+	// Copy-update: publish a modified copy of the current version. Writers are serialized.
+	template <typename F>
+	void update(F&& f) {
+		std::lock_guard<std::mutex> lock(writeMtx_);
+		auto next = std::make_unique<T>(*current_.load(std::memory_order_acquire));
+		f(*next);
+		publish(std::move(next));
+	}
+
+private:
+	std::atomic<T*> current_;
+	std::mutex writeMtx_;
+};